@@ -1,30 +1,65 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
 #include <chrono>
+#include <future>
 #include <vector>
+#include <random>
+#include <ctime>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <stdexcept>
 
 #include "App.h"
 
 #include "RenderWindow.h"
+#include "Atlas.h"
+#include "AssetLoader.h"
+#include "StaticLayer.h"
+#include "FrameScheduler.h"
+#include "SoundQueue.h"
+#include "ProfilerOverlay.h"
 #include "Vector2f.h"
 #include "Texture.h"
 #include "Sprite.h" 
-#include "Tile.h"
-#include "Ball.h"
+#include "sim/World.h"
+#include "sim/EntityStore.h"
+#include "sim/Event.h"
+#include "sim/CourseFile.h"
+#include "sim/ThreadPool.h"
+#include "sim/Profiler.h"
+#include "sim/Recording.h"
+#include "sim/Simulation.h"
+#include "sim/Preview.h"
 
 #ifdef _WIN32
-#define gen rand
-App::App(){
-    srand(time(NULL));
-    init();
+App::App(const std::vector<std::string>& courses, double tick_rate, int balls, bool headless) : loader(pool), courses(courses), headless(headless), fixed_delta_time(1.0 / tick_rate) {
+    setup.balls = balls;
+    init(time(NULL));
 }
 #else
-App::App() : gen(std::random_device()()){
-    init();
+App::App(const std::vector<std::string>& courses, double tick_rate, int balls, bool headless) : loader(pool), courses(courses), headless(headless), fixed_delta_time(1.0 / tick_rate) {
+    setup.balls = balls;
+    init(std::random_device()());
 }
 #endif
 
 App::~App(){
+    delete simulation;
+    delete preview;
+
+    // Nothing decoded may outlive the mixer
+    loader.wait();
+    if(loading){
+        for(auto& image : images){
+            SDL_FreeSurface(image.second.get());
+        }
+        Mix_FreeChunk(swingFuture.get());
+        Mix_FreeChunk(collisionFuture.get());
+        Mix_FreeChunk(holeFuture.get());
+    }
+
     Mix_FreeChunk(swingSound);
     Mix_FreeChunk(collisionSound);
     Mix_FreeChunk(holeSound);
@@ -33,6 +68,12 @@ App::~App(){
     collisionSound = nullptr;
     holeSound = nullptr;
 
+#ifdef PROFILING
+    delete overlay;
+#endif
+    delete sounds;
+    delete scheduler;
+    delete background;
     delete window;
 
     sdl::quit();
@@ -40,241 +81,403 @@ App::~App(){
         
 void App::run(){
     while(running){
-        current_time = std::chrono::steady_clock::now();
-        dt = std::chrono::duration_cast<std::chrono::microseconds>(current_time - previous_time);
-        previous_time = current_time;
+        scheduler->beginFrame();
 
-        double acc = dt.count() / 1000000.0f;
-        accumulator += acc;
+        if(simulation != nullptr){
+            state = &simulation->latest();
+        }
 
-        handleEvents();
+        {
+            PROFILE_SCOPE("handleEvents");
+            handleEvents();
+        }
 
-        updateStatic();
-        updatePhysics();
+        if(loading && loader.poll()){
+            finishLoading();
+        }
 
-        if(ball.isMoving()){
-            checkCollisions();
+        if(loading){
+            renderLoading();
+        }
+        else {
+            {
+                PROFILE_SCOPE("updateStatic");
+                updateStatic();
+            }
+
+            playEvents();
+            sounds->drain();
+
+            {
+                PROFILE_SCOPE("render");
+                render();
+            }
+
+            // Its own phase, with vsync this is where the frame waits
+            PROFILE_SCOPE("display");
+            window->display();
+        }
+
+        if(!presented){
+            presented = true;
+            SDL_Log("First frame after %.1f ms", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
+        }
+
+        scheduler->endFrame(isActive());
+
+        if(frame_limit > 0 && ++frame_count >= frame_limit){
+            post(sim::InputType::QUIT);
+            running = false;
         }
-        
-        render();
     }
+
+    logFrameStats();
+
+    if(simulation != nullptr){
+        simulation->stop();
+
+        if(!recording_path.empty() && !simulation->saveRecording()){
+            SDL_Log("Failed to write recording %s", recording_path.c_str());
+        }
+    }
+}
+
+void App::record(const std::string path){
+    recording_path = path;
+}
+
+bool App::capture(const std::string path){
+    if(!window->setCapture(path)){
+        return false;
+    }
+
+    // Nothing wakes an idle headless loop, every frame gets drawn instead
+    scheduler->setIdle(false);
+    return true;
+}
+
+void App::setDirtyRegions(bool enabled){
+    dirty_regions = enabled && (window->keepsFrame() || window->isSoftware());
+    if(enabled && !window->keepsFrame()){
+        SDL_Log(dirty_regions ? "Dirty regions on, relying on the software renderer keeping the last frame"
+                              : "Dirty regions need the software renderer or --headless, redrawing every frame");
+    }
+    redraw = true;
 }
 
-void App::init(){
+bool App::setOverlayFont(const std::string path){
+#ifdef PROFILING
+    if(overlay->open({path})){
+        return true;
+    }
+    SDL_Log("Failed to open overlay font %s, profiler overlay disabled, pick one with --overlay-font", path.c_str());
+#else
+    (void)path;
+#endif
+    return false;
+}
 
-    int flags = SDL_INIT_VIDEO;
-    int modules = sdl::SDL_IMAGE | sdl::SDL_MIXER;
+void App::setFrameLimit(int frames){
+    frame_limit = frames;
+}
+
+void App::init(unsigned int seed){
+    start_time = std::chrono::steady_clock::now();
+    setup.seed = seed;
+
+    // Headless still needs the event queue for quit, and SDL_image to decode
+    int flags = headless ? SDL_INIT_EVENTS : SDL_INIT_VIDEO;
+    int modules = headless ? sdl::SDL_IMAGE : sdl::SDL_IMAGE | sdl::SDL_MIXER;
+#ifdef PROFILING
+    modules |= sdl::SDL_TTF;
+#endif
     int imgFlags = IMG_INIT_PNG | IMG_INIT_JPG;
     sdl::initSDL(flags, modules, imgFlags);
 
-    window = new sdl::RenderWindow("SDL2 Golf", 480, 640);
+    window = new sdl::RenderWindow("SDL2 Golf", 480, 640, headless);
+
+    background = new sdl::StaticLayer(window);
+    dirty_regions = window->keepsFrame();
 
-    ball.setTexture(window->loadTextureFromFile("../../res/imgs/golf_ball.png"));
-    hole.setTexture(window->loadTextureFromFile("../../res/imgs/hole.png"));
+    // No display to sync to offscreen, capped keeps the frames as far apart as on screen
+    scheduler = new sdl::FrameScheduler(window, headless ? sdl::CAPPED : sdl::VSYNC);
+    sounds = new sdl::SoundQueue();
+
+#ifdef PROFILING
+    overlay = new sdl::ProfilerOverlay(window);
+    setOverlayFont(OVERLAY_FONT);
+#endif
+
+    // Written by `make atlas`, without it every image gets its own texture
+    packed = atlas.load("../../res/imgs/atlas.txt");
+
+    std::vector<std::string> paths = {"../../res/imgs/field.jpg"};
+    if(packed){
+        paths.push_back(atlas.getImagePath());
+    }
+    else {
+        for(const char* name : {"golf_ball", "hole", "arrow", "powerbar", "powerbar_bg", "tile"}){
+            paths.push_back(std::string("../../res/imgs/") + name + ".png");
+        }
+    }
+
+    // Decoding happens on the pool while the window shows a progress bar
+    loader.setProgressCallback([this](size_t finished, size_t total){
+        load_progress = (float)finished / total;
+    });
+
+    for(const std::string& path : paths){
+        images.push_back({path, loader.loadSurface(path)});
+    }
+
+    swingFuture = loader.loadSound("../../res/sounds/swing.wav");
+    collisionFuture = loader.loadSound("../../res/sounds/collision.wav");
+    holeFuture = loader.loadSound("../../res/sounds/hole.wav");
+}
+
+void App::finishLoading(){
+    // Upload under the same paths the sprites ask for, so the calls below are cache hits
+    // All checked before any is freed, after a throw the destructor frees every surface once
+    for(auto& image : images){
+        if(image.second.get() == nullptr){
+            throw std::runtime_error("Failed to load image " + image.first);
+        }
+    }
+
+    // Out of images before the first upload, one that throws leaks the rest rather than freeing them twice
+    std::vector<std::pair<std::string, std::shared_future<SDL_Surface*>>> decoded;
+    decoded.swap(images);
+
+    std::vector<sdl::TextureHandle> preloaded;
+    for(auto& image : decoded){
+        SDL_Surface* surface = image.second.get();
+        preloaded.push_back(window->loadTextureFromSurface(image.first, surface));
+        SDL_FreeSurface(surface);
+    }
+
+    loadSprite(ball, "golf_ball");
+    loadSprite(hole, "hole");
     field.setTexture(window->loadTextureFromFile("../../res/imgs/field.jpg"));
-    arrow.setTexture(window->loadTextureFromFile("../../res/imgs/arrow.png"));
-    powerbar.setTexture(window->loadTextureFromFile("../../res/imgs/powerbar.png"));
-    powerbar_bg.setTexture(window->loadTextureFromFile("../../res/imgs/powerbar_bg.png"));
+    loadSprite(arrow, "arrow");
+    loadSprite(powerbar, "powerbar");
+    loadSprite(powerbar_bg, "powerbar_bg");
+
+    loadSprite(tile, "tile");
+
+    loadSprite(dot, "golf_ball");
+    dot.setScale(4, 4);
+
+    // The sprites the course overrides go back to, they keep their own texture references
+    default_sprites[sim::BALL_TEXTURE] = ball;
+    default_sprites[sim::HOLE_TEXTURE] = hole;
+    default_sprites[sim::TILE_TEXTURE] = tile;
+    default_sprites[sim::FIELD_TEXTURE] = field;
 
-    sdl::Texture* tileTexture = window->loadTextureFromFile("../../res/imgs/tile.png");
-    for(int i = 0; i < 5; i++){
-        Tile tile(tileTexture);
-        tile.setScale(tileTexture->getWidth(), tileTexture->getHeight());
-        tiles.push_back(tile);
+    for(sdl::TextureHandle texture : preloaded){
+        window->releaseTexture(texture);
     }
 
-    randomize();
+    // Fail now rather than on the hole that needs it
+    for(const std::string& path : courses){
+        sim::CourseFile file;
+        if(!file.open(path)){
+            throw std::runtime_error("Failed to load course file " + path);
+        }
+    }
+
+    // Everything the simulation, and a replay of it, needs to build the world
+    setup.dt = fixed_delta_time;
+    setup.width = window->getWidth();
+    setup.height = window->getHeight();
+    setup.ball_scale = ball.getScale();
+    setup.hole_scale = hole.getScale();
+    setup.tile_scale = tile.getScale();
+    setup.tile_count = 5;
+    setup.courses = courses;
+
+    swingSound = swingFuture.get();
+    collisionSound = collisionFuture.get();
+    holeSound = holeFuture.get();
+
+    preview = new sim::Preview(fixed_delta_time);
+
+    simulation = new sim::Simulation(setup, recording_path);
+    simulation->start();
+    state = &simulation->latest();
+
+    loading = false;
+
+    SDL_Log("Assets ready after %.1f ms", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+void App::renderLoading(){
+    window->clear();
+    window->flush();
 
-    swingSound = Mix_LoadWAV("../../res/sounds/swing.wav");
-    collisionSound = Mix_LoadWAV("../../res/sounds/collision.wav");
-    holeSound = Mix_LoadWAV("../../res/sounds/hole.wav");
+    // Offscreen frames show just the clear while loading
+    SDL_Renderer* renderer = window->getRenderer();
+    if(renderer == nullptr){
+        window->display();
+        return;
+    }
+
+    SDL_FRect frame = {window->getWidth() / 4.0f, window->getHeight() / 2.0f - 8, window->getWidth() / 2.0f, 16};
+    SDL_FRect bar = {frame.x + 2, frame.y + 2, (frame.w - 4) * load_progress, frame.h - 4};
+
+    SDL_SetRenderDrawColor(renderer, 0x40, 0x40, 0x40, 0xFF);
+    SDL_RenderDrawRectF(renderer, &frame);
+    SDL_SetRenderDrawColor(renderer, 0x3C, 0xB0, 0x43, 0xFF);
+    SDL_RenderFillRectF(renderer, &bar);
+
+    window->display();
 }
 
 void App::handleEvents() {
     SDL_Event event;
-    SDL_FRect ball_rect = ball.getRect();
 
     while (SDL_PollEvent(&event)) {
+        if (loading && event.type != SDL_QUIT) {
+            continue;
+        }
+
         switch (event.type) {
             case SDL_QUIT:
+                post(sim::InputType::QUIT);
                 running = false;
                 break;
+            // Positions come from the event, not the current mouse state, so a recording replays exactly
             case SDL_MOUSEBUTTONDOWN:
-                handleMouseButtonDown(ball_rect);
+                post(sim::InputType::MOUSE_DOWN, event.button.x, event.button.y);
                 break;
             case SDL_MOUSEBUTTONUP:
-                if(lock)
-                    handleMouseButtonUp(ball_rect);
+                post(sim::InputType::MOUSE_UP, event.button.x, event.button.y);
                 break;
             case SDL_KEYDOWN:
+                post(sim::InputType::KEY, 0, 0, event.key.keysym.sym);
                 handleKeyDown(event);
                 break;
+            case SDL_WINDOWEVENT:
+                if(event.window.event == SDL_WINDOWEVENT_EXPOSED)
+                    redraw = true;
+                break;
+            case SDL_RENDER_TARGETS_RESET:
+            case SDL_RENDER_DEVICE_RESET:
+                background->invalidate();
+                break;
         }
     }
 }
 
-void App::handleMouseButtonDown(const SDL_FRect& ball_rect) {
-    if (!ball.isMoving()) {
-        int x, y;
-        SDL_GetMouseState(&x, &y);
-
-        if (x > ball_rect.x && x < ball_rect.x + ball_rect.w &&
-            y > ball_rect.y && y < ball_rect.y + ball_rect.h) {
-            lock = true;
-        }
+void App::post(sim::InputType type, int32_t x, int32_t y, int32_t key){
+    if(simulation == nullptr){
+        return;
     }
-}
-
-void App::handleMouseButtonUp(const SDL_FRect& ball_rect) {
-    int x, y;
-    SDL_GetMouseState(&x, &y);
-
-    math::Vector2f golf_ball_velocity = math::Vector2f(-(x - (ball_rect.x + ball_rect.w / 2)),
-                                                        -(y - (ball_rect.y + ball_rect.h / 2)));
-    ball.setVelocity1D(golf_ball_velocity.magnitude());
-
-    if (ball.getVelocity1D() > ball_rect.w / 2.0f) {
-        if (ball.getVelocity1D() > 100.0f) {
-            ball.setVelocity1D(100.0f);
-            float angle = atan2(golf_ball_velocity.y, golf_ball_velocity.x);
-            golf_ball_velocity.x = cos(angle) * ball.getVelocity1D();
-            golf_ball_velocity.y = sin(angle) * ball.getVelocity1D();
-        }
-
-        golf_ball_velocity *= 10.0f;
-
-        ball.setVelocity(golf_ball_velocity);
-        ball.setMoving(true);
 
-        lock = false;
-        draw_aux = false;
-
-        Mix_PlayChannel(-1, swingSound, 0);
-        Mix_Volume(-1, ball.getVelocity1D() * 1.28f);
+    // The tick field is stamped by the simulation when the input is applied
+    if(!simulation->post({0, type, x, y, key})){
+        SDL_Log("Input queue full, dropped an input");
     }
+
+    // Stay awake until the simulation has had a chance to react
+    wake_tick = state->tick + 2;
 }
 
 void App::handleKeyDown(const SDL_Event& event) {
     switch (event.key.keysym.sym) {
-        case SDLK_SPACE:
-            if (win) {
-                resetGame();
-            }
+#ifdef PROFILING
+        case SDLK_p:
+            overlay->toggle();
+            break;
+        case SDLK_t:
+            if(sim::Profiler::get().writeTrace("trace.json"))
+                SDL_Log("Wrote trace.json");
+            break;
+#endif
+        case SDLK_g:
+            draw_preview = !draw_preview;
+            SDL_Log("Aim preview %s", draw_preview ? "on" : "off");
+            break;
+        case SDLK_v:
+            logFrameStats();
+            scheduler->setMode((sdl::FrameMode)((scheduler->getMode() + 1) % (sdl::CAPPED + 1)));
+            SDL_Log("Frame mode %s", sdl::FrameScheduler::modeName(scheduler->getMode()));
             break;
     }
 }
 
-void App::resetGame() {
-    ball.setScale(ball.getTexture()->getWidth(), ball.getTexture()->getHeight());
-    randomize();
-
-    win = false;
-}
-
-void App::randomize(){
-    
-    int x, y;
-    x = (gen() % (window->getWidth() - (int)ball.getScale().x * 2)) + ball.getScale().x;
-    y = window->getHeight() - ball.getScale().y - 30;
-    ball.setPosition(x ,y);
-
-    x = (gen() % (window->getWidth() - (int)hole.getScale().x * 2)) + hole.getScale().x;
-    y = (gen() % (window->getHeight() / 4 - (int)hole.getScale().y * 2)) + hole.getScale().y;
-    hole.setPosition(x, y);
-
-    for(Tile &tile : tiles){
-        do{
-            x = (gen() % (window->getWidth() - (int)tile.getScale().x * 2)) + tile.getScale().x;
-            y = (gen() % (window->getHeight() - (int)tile.getScale().y * 2 - (int)ball.getScale().y - 50)) + tile.getScale().y;
-            tile.setPosition(x, y);
-        } while(tile.collidesWith(hole) != sdl::sdlDirection::SDL_NONE);
+void App::loadCourseTextures(size_t index) {
+    // Every hole starts from the defaults, overrides only last for the course that names them
+    sdl::Sprite* slots[sim::TEXTURE_SLOTS] = {&ball, &hole, &tile, &field};
+    sdl::TextureHandle previous[sim::TEXTURE_SLOTS];
+    for(int i = 0; i < sim::TEXTURE_SLOTS; i++){
+        previous[i] = overrides[i];
+        overrides[i] = sdl::TextureHandle();
+        *slots[i] = default_sprites[i];
     }
-}
-
-void App::updatePhysics(){
-    while(accumulator >= FIXED_DELTA_TIME){
-        ball.update(FIXED_DELTA_TIME);
 
-        if(ball.getPosition().x < 0){
-            ball.setPosition(0.0f, ball.getPosition().y);
-            ball.setVelocity(-ball.getVelocity().x, ball.getVelocity().y);
-            Mix_PlayChannel(-1, collisionSound, 0);
-            Mix_Volume(-1, ball.getVelocity1D() * 1.28f );
-        }
-        else if(ball.getPosition().x + ball.getScale().x > window->getWidth()){
-            ball.setPosition(window->getWidth() - ball.getScale().x, ball.getPosition().y);
-            ball.setVelocity(-ball.getVelocity().x, ball.getVelocity().y);
-            Mix_PlayChannel(-1, collisionSound, 0);
-            Mix_Volume(-1, ball.getVelocity1D() * 1.28f );
-        }
-
-        if(ball.getPosition().y < 0){
-            ball.setPosition(ball.getPosition().x, 0.0f);
-            ball.setVelocity(ball.getVelocity().x, -ball.getVelocity().y);
-            Mix_PlayChannel(-1, collisionSound, 0);
-            Mix_Volume(-1, ball.getVelocity1D() * 1.28f );
-        }
-        else if(ball.getPosition().y + ball.getScale().y > window->getHeight()){
-            ball.setPosition(ball.getPosition().x, window->getHeight() - ball.getScale().y);
-            ball.setVelocity(ball.getVelocity().x, -ball.getVelocity().y);
-            Mix_PlayChannel(-1, collisionSound, 0);
-            Mix_Volume(-1, ball.getVelocity1D() * 1.28f );
-        }
-
-
-        if(!win){
-            float distance = sqrt(pow(ball.getCenter().x - hole.getCenter().x, 2) + pow(ball.getCenter().y - hole.getCenter().y, 2));
-            if(distance < 7.5f && ball.getVelocity1D() < 70.0f
-                /*ball.getPosition().x > hole.getPosition().x - 5 && 
-                ball.getPosition().x + ball.getScale().x < hole.getPosition().x + hole.getScale().x + 5 && 
-                ball.getPosition().y > hole.getPosition().y - 5 && 
-                ball.getPosition().y + ball.getScale().y < hole.getPosition().y + hole.getScale().y + 5*/)
-            {
-                ball.setVelocity(0.0f, 0.0f);
-                ball.setMoving(false);
-                win = true;
-                Mix_PlayChannel(-1, holeSound, 0);
+    sim::CourseFile file;
+    if(file.open(courses[index])){
+        for(size_t i = 0; i < file.getTextureCount(); i++){
+            const sim::TextureRef& ref = file.getTextures()[i];
+            if(ref.slot < sim::TEXTURE_SLOTS){
+                std::string path(ref.path, strnlen(ref.path, sizeof(ref.path)));
+                window->releaseTexture(overrides[ref.slot]);
+                overrides[ref.slot] = sdl::TextureHandle();
+                *slots[ref.slot] = default_sprites[ref.slot];
+
+                // Mid-game, a missing file costs the course its override and nothing more
+                try {
+                    overrides[ref.slot] = window->loadTextureFromFile(path);
+                }
+                catch(const std::runtime_error& e){
+                    SDL_Log("Failed to load course texture %s, keeping the default: %s", path.c_str(), e.what());
+                    continue;
+                }
+                slots[ref.slot]->setTexture(overrides[ref.slot]);
             }
         }
-        else {
-            ball.shrink(0.5f);
-        }
+    }
 
-        accumulator -= FIXED_DELTA_TIME;
+    // Released after the new ones are taken, so a texture two courses share stays loaded
+    for(sdl::TextureHandle texture : previous){
+        window->releaseTexture(texture);
     }
 }
 
-void App::checkCollisions(){
-    for(Tile t : tiles){
-        sdl::sdlDirection dir = ball.collidesWith(t);
-        if(dir != sdl::sdlDirection::SDL_NONE){
-            if(dir == sdl::sdlDirection::SDL_LEFT){
-                ball.setPosition(t.getPosition().x - ball.getScale().x, ball.getPosition().y);
-                ball.setVelocity(-ball.getVelocity().x, ball.getVelocity().y);
-            } else if(dir == sdl::sdlDirection::SDL_RIGHT){
-                ball.setPosition(t.getPosition().x + t.getScale().x, ball.getPosition().y);
-                ball.setVelocity(-ball.getVelocity().x, ball.getVelocity().y);
-            } else if(dir == sdl::sdlDirection::SDL_UP){
-                ball.setPosition(ball.getPosition().x, t.getPosition().y - ball.getScale().y);
-                ball.setVelocity(ball.getVelocity().x, -ball.getVelocity().y);
-            } else if(dir == sdl::sdlDirection::SDL_DOWN){
-                ball.setPosition(ball.getPosition().x, t.getPosition().y + t.getScale().y);
-                ball.setVelocity(ball.getVelocity().x, -ball.getVelocity().y);
-            }
-            Mix_PlayChannel(-1, collisionSound, 0);
-            Mix_Volume(-1, ball.getVelocity1D() * 1.28f );
+void App::loadSprite(sdl::Sprite& sprite, const std::string name) {
+    if(packed && atlas.apply(window, name, sprite)){
+        return;
+    }
 
-            break;
+    sprite.setTexture(window->loadTextureFromFile("../../res/imgs/" + name + ".png"));
+}
+
+void App::playEvents(){
+    sim::Event event;
+    while(simulation->pollEvent(event)){
+        switch(event.type){
+            case sim::EventType::SWING:
+                draw_aux = false;
+                sounds->push(swingSound, event.velocity * 1.28f);
+                break;
+            case sim::EventType::WALL_COLLISION:
+            case sim::EventType::TILE_COLLISION:
+            case sim::EventType::BALL_COLLISION:
+                sounds->push(collisionSound, event.velocity * 1.28f);
+                break;
+            case sim::EventType::HOLE_IN:
+                sounds->push(holeSound);
+                break;
         }
     }
 }
 
 void App::updateStatic(){
-    if(lock){
+    if(state->aiming){
         int x, y;
         SDL_GetMouseState(&x, &y);
 
-        SDL_FRect ball_rect = ball.getRect();
+        SDL_FRect ball_rect = getBallRect();
 
         float startX = ball_rect.x + ball_rect.w / 2;
         float startY = ball_rect.y + ball_rect.h / 2;
@@ -287,6 +490,10 @@ void App::updateStatic(){
 
             draw_aux = true;
 
+            if(draw_preview){
+                updatePreview(math::Vector2f(-(x - (ball_rect.x + ball_rect.w / 2)), -(y - (ball_rect.y + ball_rect.h / 2))));
+            }
+
             if(segmentLength > 100.0f){
                 segmentLength = 100.0f;
             }
@@ -310,24 +517,176 @@ void App::updateStatic(){
     }
 }
 
+void App::updatePreview(math::Vector2f aim){
+    // Aiming only starts with every ball at rest, so the snapshot is exactly where the shot starts from
+    math::Vector2f position = state->entities.getPosition(0);
+    if(preview_version != state->course_version || preview_ball.x != position.x || preview_ball.y != position.y){
+        sim::Course course;
+        course.width = setup.width;
+        course.height = setup.height;
+        course.ball_position = position;
+        course.ball_scale = setup.ball_scale;
+        course.hole_position = state->hole.getPosition();
+        course.hole_scale = state->hole.getScale();
+        course.tiles = state->tiles;
+        preview->setCourse(course);
+
+        preview_version = state->course_version;
+        preview_ball = position;
+    }
+
+    preview_dots = &preview->predict(aim);
+}
+
 void App::render(){
-    window->clear();
+    // A new hole means a new static layer
+    if(layer_version != state->course_version){
+        if(!courses.empty()){
+            loadCourseTextures(state->course_index);
+        }
+        background->invalidate();
+        layer_version = state->course_version;
+    }
 
-    window->render(field);
-    window->render(hole);
+    if(!background->isValid()){
+        renderBackground();
+        redraw = true;
+    }
 
-    for(Tile t : tiles){
-        window->render(t);
+    bool partial = dirty_regions && !redraw;
+    window->clear(!partial);
+
+    if(partial){
+        background->restore(dirty);
+    }
+    else {
+        background->draw();
+    }
+    redraw = false;
+    dirty.clear();
+
+    if(state->aiming && draw_aux && draw_preview && preview_dots != nullptr){
+        for(const math::Vector2f& center : *preview_dots){
+            dot.setPosition(center - dot.getScale() / 2);
+            window->render(dot);
+            dirty.push_back(getBounds(dot));
+        }
     }
 
-    if(lock && draw_aux){
+    if(state->aiming && draw_aux){
         window->render(arrow);
         window->render(powerbar_bg);
         window->render(powerbar);
+
+        dirty.push_back(getBounds(arrow));
+        dirty.push_back(getBounds(powerbar_bg));
+        dirty.push_back(getBounds(powerbar));
     }
 
-    window->render(ball);
+    // The snapshot is the state due at state->time, blend towards it from the tick before
+    float alpha = std::chrono::duration<float>(std::chrono::steady_clock::now() - state->time).count() / fixed_delta_time;
+    alpha = std::min(1.0f, std::max(0.0f, alpha));
 
-    window->display();
+    const sim::EntityStore& entities = state->entities;
+    for(size_t i = 0; i < entities.size(); i++){
+        ball.setPosition(state->previous_position[i] + (entities.getPosition(i) - state->previous_position[i]) * alpha);
+        ball.setScale(state->previous_extent[i] + (entities.extent[i] - state->previous_extent[i]) * alpha);
+        window->render(ball);
+        dirty.push_back(getBounds(ball));
+    }
+
+#ifdef PROFILING
+    overlay->update();
+    if(overlay->isVisible()){
+        overlay->render();
+        dirty.push_back(overlay->getBounds());
+    }
+#endif
+}
+
+void App::renderBackground(){
+    background->begin();
+
+    window->render(field);
+
+    hole.setPosition(state->hole.getPosition());
+    hole.setScale(state->hole.getScale());
+    window->render(hole);
+
+    for(const sim::Tile& t : state->tiles){
+        tile.setPosition(t.getPosition());
+        tile.setScale(t.getScale());
+        window->render(tile);
+    }
+
+    background->end();
+}
+
+SDL_Rect App::getBounds(sdl::Sprite& sprite) const {
+    math::Vector2f position = sprite.getPosition();
+    math::Vector2f scale = sprite.getScale();
+
+    float minX = position.x, minY = position.y;
+    float maxX = position.x + scale.x, maxY = position.y + scale.y;
+
+    if(sprite.getAngle() != 0){
+        SDL_FPoint* center = sprite.getRotationCenter();
+        float cx = position.x + (center != nullptr ? center->x : scale.x / 2);
+        float cy = position.y + (center != nullptr ? center->y : scale.y / 2);
+
+        float radians = sprite.getAngle() * M_PI / 180;
+        float c = cos(radians), s = sin(radians);
+
+        float xs[4] = {position.x, position.x + scale.x, position.x + scale.x, position.x};
+        float ys[4] = {position.y, position.y, position.y + scale.y, position.y + scale.y};
+
+        minX = maxX = cx;
+        minY = maxY = cy;
+        for(int i = 0; i < 4; i++){
+            float x = cx + (xs[i] - cx) * c - (ys[i] - cy) * s;
+            float y = cy + (xs[i] - cx) * s + (ys[i] - cy) * c;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+    }
+
+    // One extra pixel for the edge linear filtering bleeds into
+    int left = std::max(0, (int)floor(minX) - 1);
+    int top = std::max(0, (int)floor(minY) - 1);
+    int right = std::min(window->getWidth(), (int)ceil(maxX) + 1);
+    int bottom = std::min(window->getHeight(), (int)ceil(maxY) + 1);
+
+    return {left, top, std::max(0, right - left), std::max(0, bottom - top)};
+}
+
+bool App::isActive() const {
+    // Once in the hole the ball keeps shrinking until it is gone,
+    // and the interpolated ball lags one tick behind the simulation
+    // and input shows up a tick or two after it was posted
+    if(loading || state->aiming || state->moving || state->tick < wake_tick || (state->won && state->entities.extent[0].x > 0)){
+        return true;
+    }
+
+    for(size_t i = 0; i < state->entities.size(); i++){
+        math::Vector2f position = state->entities.getPosition(i);
+        if(state->previous_position[i].x != position.x || state->previous_position[i].y != position.y){
+            return true;
+        }
+    }
+    return false;
+}
+
+void App::logFrameStats() const {
+    const sdl::FrameStats& stats = scheduler->getStats();
+    if(stats.frames > 0){
+        SDL_Log("%s: %zu frames, %.2f ms mean, %.2f ms jitter, %.2f-%.2f ms", sdl::FrameScheduler::modeName(scheduler->getMode()),
+                stats.frames, stats.mean, stats.jitter, stats.min, stats.max);
+    }
+}
 
+SDL_FRect App::getBallRect() const {
+    math::Vector2f position = state->entities.getPosition(0);
+    return {position.x, position.y, state->entities.extent[0].x, state->entities.extent[0].y};
 }
\ No newline at end of file
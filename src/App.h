@@ -4,72 +4,176 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_mixer.h>
 #include <chrono>
+#include <future>
 #include <vector>
-#include <random>
+#include <string>
 
 #include "RenderWindow.h"
-#include "Sprite.h" 
-#include "Ball.h"
-#include "Tile.h"
-
+#include "Atlas.h"
+#include "AssetLoader.h"
+#include "StaticLayer.h"
+#include "FrameScheduler.h"
+#include "SoundQueue.h"
+#include "ProfilerOverlay.h"
+#include "Sprite.h"
+#include "sim/Event.h"
+#include "sim/CourseFile.h"
+#include "sim/ThreadPool.h"
+#include "sim/Recording.h"
+#include "sim/Simulation.h"
+#include "sim/Preview.h"
+
+// Owns the window and draws, the world itself runs on the simulation thread
+// and only reaches this side through its snapshots and events
 class App
 {
     public:
-        App();
+        // tick_rate is the physics rate in Hz, rendering interpolates between ticks.
+        // balls is how many extra balls get scattered over every course.
+        // headless renders offscreen without a window or sound, see capture
+        App(const std::vector<std::string>& courses = std::vector<std::string>(), double tick_rate = 62.5, int balls = 0, bool headless = false);
 
         ~App();
-        
+
         void run();
 
+        // Writes the session to path when run() returns, play it back with the replay tool
+        void record(const std::string path);
+
+        // Headless only, every frame goes to path as RenderWindow::setCapture describes
+        bool capture(const std::string path);
+
+        // Redraw only what moved. Always on headless, where the last frame is guaranteed to stay. The software
+        // renderer keeps it too but SDL does not promise that, so there it is only on when asked for
+        void setDirtyRegions(bool enabled);
+
+        // TrueType font for the profiler overlay, only in PROFILING builds. No font ships with the game,
+        // OVERLAY_FONT is where one is looked for by default
+        bool setOverlayFont(const std::string path);
+
+        static constexpr const char* OVERLAY_FONT = "../../res/fonts/overlay.ttf";
+
+        // run() returns after this many frames, 0 runs until quit
+        void setFrameLimit(int frames);
+
     private:
 
-        void init();
+        void init(unsigned int seed);
 
-        void handleEvents();
+        // Runs once the loader has decoded every asset queued by init, then starts the simulation
+        void finishLoading();
 
-        void handleMouseButtonDown(const SDL_FRect& ball_rect);
+        void renderLoading();
 
-        void handleMouseButtonUp(const SDL_FRect& ball_rect);
+        void handleEvents();
+
+        // Hands an input to the simulation thread
+        void post(sim::InputType type, int32_t x = 0, int32_t y = 0, int32_t key = 0);
 
+        // Keys that only concern this side, the simulation gets every key as well
         void handleKeyDown(const SDL_Event& event);
 
-        void resetGame();
-        void randomize();
+        // Course override textures for the hole the snapshot is on
+        void loadCourseTextures(size_t index);
+        void loadSprite(sdl::Sprite& sprite, const std::string name);
 
-        void updatePhysics();
-        void checkCollisions();
         void updateStatic();
 
+        // Dotted path of the shot being aimed, only runs the physics again for a new aim or a new resting place
+        void updatePreview(math::Vector2f aim);
+
+        // Queues the sounds for the simulation's events, the queue reaches the mixer once per frame
+        void playEvents();
+
         void render();
+        void renderBackground();
+
+        // Screen rect a sprite covers, rotation included, clamped to the window
+        SDL_Rect getBounds(sdl::Sprite& sprite) const;
+
+        SDL_FRect getBallRect() const;
+
+        // Whether the next frame can differ from the last one without any input
+        bool isActive() const;
+
+        void logFrameStats() const;
 
         sdl::RenderWindow* window;
 
-        Ball ball;
+        // Setup for the simulation, and the recording header when one is written
+        sim::Recording setup;
+        std::string recording_path;
+
+        sim::Simulation* simulation = nullptr;
+
+        // Newest snapshot, read once at the start of every frame
+        const sim::Snapshot* state = nullptr;
+
+        // Tick up to which the frame loop stays awake after posting input, so the reaction is drawn
+        uint32_t wake_tick = 0;
+
+        // Course the static layer was drawn for
+        uint32_t layer_version = 0;
+
+        sdl::StaticLayer* background = nullptr;
+        sdl::FrameScheduler* scheduler = nullptr;
+        sdl::SoundQueue* sounds = nullptr;
+
+        // Toggled with G, off by default
+        sim::Preview* preview = nullptr;
+        const std::vector<math::Vector2f>* preview_dots = nullptr;
+        bool draw_preview = false;
+        uint32_t preview_version = 0;
+        math::Vector2f preview_ball;
+
+#ifdef PROFILING
+        sdl::ProfilerOverlay* overlay = nullptr;
+#endif
+
+        // Rects drawn over the background last frame, restored instead of a full redraw when dirty_regions is on
+        std::vector<SDL_Rect> dirty;
+        bool dirty_regions = false, redraw = true;
+
+        sdl::Atlas atlas;
+        bool packed = false;
+
+        sim::ThreadPool pool;
+        sdl::AssetLoader loader;
+
+        std::vector<std::pair<std::string, std::shared_future<SDL_Surface*>>> images;
+        std::shared_future<Mix_Chunk*> swingFuture;
+        std::shared_future<Mix_Chunk*> collisionFuture;
+        std::shared_future<Mix_Chunk*> holeFuture;
+
+        bool loading = true, presented = false;
+        float load_progress = 0.0f;
+        std::chrono::steady_clock::time_point start_time;
+
+        std::vector<std::string> courses;
+
+        sdl::Sprite ball;
         sdl::Sprite hole;
+        sdl::Sprite tile;
         sdl::Sprite field;
         sdl::Sprite arrow;
         sdl::Sprite powerbar;
         sdl::Sprite powerbar_bg;
+        sdl::Sprite dot;
 
-        Mix_Chunk* swingSound;
-        Mix_Chunk* collisionSound;
-        Mix_Chunk* holeSound;
-
-        std::vector<Tile> tiles;
-
-        std::chrono::steady_clock::time_point current_time;
-        std::chrono::steady_clock::time_point previous_time;
+        // Indexed by sim::TextureSlot: the sprites before any course override, and the override textures in use
+        sdl::Sprite default_sprites[sim::TEXTURE_SLOTS];
+        sdl::TextureHandle overrides[sim::TEXTURE_SLOTS];
 
-        std::chrono::microseconds dt;
+        Mix_Chunk* swingSound = nullptr;
+        Mix_Chunk* collisionSound = nullptr;
+        Mix_Chunk* holeSound = nullptr;
 
-        double accumulator = 0.0;
-        bool lock = false, win = false, running = true, draw_aux = false;
+        bool running = true, draw_aux = false;
+        bool headless;
 
-        const double FIXED_DELTA_TIME = 0.016;
+        int frame_limit = 0, frame_count = 0;
 
-        #ifndef _WIN32
-        std::mt19937 gen;
-        #endif
+        double fixed_delta_time = 0.016;
 };
 
-#endif // APP_H
\ No newline at end of file
+#endif // APP_H
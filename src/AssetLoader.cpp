@@ -0,0 +1,75 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_mixer.h>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "AssetLoader.h"
+
+#include "sim/ThreadPool.h"
+
+sdl::AssetLoader::AssetLoader(sim::ThreadPool& pool)
+: pool(pool), finished(0) {}
+
+sdl::AssetLoader::~AssetLoader(){
+    // Tasks still count into this loader
+    if(finished.load() != total){
+        pool.wait();
+    }
+}
+
+std::shared_future<SDL_Surface*> sdl::AssetLoader::loadSurface(const std::string path){
+    std::shared_ptr<std::promise<SDL_Surface*>> promise = std::make_shared<std::promise<SDL_Surface*>>();
+    std::shared_future<SDL_Surface*> future = promise->get_future().share();
+
+    total++;
+    pool.submit([this, promise, path](){
+        promise->set_value(IMG_Load(path.c_str()));
+        finished++;
+    });
+
+    return future;
+}
+
+std::shared_future<Mix_Chunk*> sdl::AssetLoader::loadSound(const std::string path){
+    std::shared_ptr<std::promise<Mix_Chunk*>> promise = std::make_shared<std::promise<Mix_Chunk*>>();
+    std::shared_future<Mix_Chunk*> future = promise->get_future().share();
+
+    total++;
+    pool.submit([this, promise, path](){
+        promise->set_value(Mix_LoadWAV(path.c_str()));
+        finished++;
+    });
+
+    return future;
+}
+
+void sdl::AssetLoader::setProgressCallback(std::function<void(size_t, size_t)> callback){
+    progress = callback;
+}
+
+bool sdl::AssetLoader::poll(){
+    size_t done = finished.load();
+    if(done != reported){
+        reported = done;
+        if(progress){
+            progress(done, total);
+        }
+    }
+    return done == total;
+}
+
+void sdl::AssetLoader::wait(){
+    pool.wait();
+    poll();
+}
+
+size_t sdl::AssetLoader::getFinished() const {
+    return finished.load();
+}
+
+size_t sdl::AssetLoader::getTotal() const {
+    return total;
+}
@@ -0,0 +1,51 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <string>
+
+#include "sim/ThreadPool.h"
+
+namespace sdl {
+
+// Decodes images and sounds on a worker pool, only the texture upload is left to the render thread.
+// Results are handed over through futures and belong to whoever takes them, a failed load yields nullptr
+class AssetLoader
+{
+    public:
+        AssetLoader(sim::ThreadPool& pool);
+
+        ~AssetLoader();
+
+        std::shared_future<SDL_Surface*> loadSurface(const std::string path);
+
+        std::shared_future<Mix_Chunk*> loadSound(const std::string path);
+
+        // Called from poll with (finished, total), so it runs on the thread that polls
+        void setProgressCallback(std::function<void(size_t, size_t)> callback);
+
+        // Reports any new progress, true once everything queued so far has finished
+        bool poll();
+
+        void wait();
+
+        size_t getFinished() const;
+
+        size_t getTotal() const;
+
+    private:
+        sim::ThreadPool& pool;
+
+        std::function<void(size_t, size_t)> progress;
+
+        std::atomic<size_t> finished;
+        size_t total = 0;
+        size_t reported = 0;
+};
+}
+
+#endif // ASSETLOADER_H
@@ -0,0 +1,92 @@
+#include <SDL2/SDL.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include "Atlas.h"
+
+#include "RenderWindow.h"
+#include "Sprite.h"
+
+sdl::Atlas::Atlas() {}
+
+// Format:
+//   image <file, relative to the table>
+//   region <name> <x> <y> <w> <h>
+bool sdl::Atlas::load(const std::string path){
+    std::ifstream in(path);
+    if(!in){
+        return false;
+    }
+
+    std::string directory;
+    size_t slash = path.find_last_of("/\\");
+    if(slash != std::string::npos){
+        directory = path.substr(0, slash + 1);
+    }
+
+    std::string line;
+    std::string image;
+    std::unordered_map<std::string, SDL_Rect> table;
+
+    while(std::getline(in, line)){
+        std::istringstream fields(line);
+        std::string key;
+        if(!(fields >> key) || key[0] == '#'){
+            continue;
+        }
+
+        if(key == "image"){
+            if(!(fields >> image)){
+                return false;
+            }
+        }
+        else if(key == "region"){
+            std::string name;
+            SDL_Rect rect;
+            if(!(fields >> name >> rect.x >> rect.y >> rect.w >> rect.h) || rect.w <= 0 || rect.h <= 0){
+                return false;
+            }
+            table[name] = rect;
+        }
+        else {
+            return false;
+        }
+    }
+
+    if(image.empty() || table.empty()){
+        return false;
+    }
+
+    image_path = directory + image;
+    regions.swap(table);
+    return true;
+}
+
+bool sdl::Atlas::has(const std::string name) const {
+    return regions.find(name) != regions.end();
+}
+
+const SDL_Rect* sdl::Atlas::getRegion(const std::string name) const {
+    auto it = regions.find(name);
+    return it != regions.end() ? &it->second : nullptr;
+}
+
+bool sdl::Atlas::apply(sdl::RenderWindow* window, const std::string name, sdl::Sprite& sprite) const {
+    const SDL_Rect* region = getRegion(name);
+    if(region == nullptr){
+        return false;
+    }
+
+    sprite.setTexture(window->loadTextureFromFile(image_path), *region);
+    return true;
+}
+
+const std::string& sdl::Atlas::getImagePath() const {
+    return image_path;
+}
+
+size_t sdl::Atlas::size() const {
+    return regions.size();
+}
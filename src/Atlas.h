@@ -0,0 +1,39 @@
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+
+#include "RenderWindow.h"
+#include "Sprite.h"
+
+namespace sdl {
+
+// Sub-rect table for a packed texture, written by the atlas tool
+class Atlas
+{
+    public:
+        Atlas();
+
+        // Reads the table, the packed texture is loaded on the first apply
+        bool load(const std::string path);
+
+        bool has(const std::string name) const;
+
+        const SDL_Rect* getRegion(const std::string name) const;
+
+        // Points the sprite at the named region, holding one cache reference per call
+        bool apply(sdl::RenderWindow* window, const std::string name, sdl::Sprite& sprite) const;
+
+        const std::string& getImagePath() const;
+
+        size_t size() const;
+
+    private:
+        std::string image_path;
+        std::unordered_map<std::string, SDL_Rect> regions;
+};
+}
+
+#endif // ATLAS_H
@@ -0,0 +1,454 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Compositor.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define COMPOSITOR_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Exact round(x / 255) for x up to 255 * 255
+inline uint32_t div255(uint32_t x){
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline uint32_t over(uint32_t dst, uint32_t src){
+    uint32_t inv = 255 - (src >> 24);
+    uint32_t result = 0;
+    for(int shift = 0; shift < 32; shift += 8){
+        uint32_t channel = ((src >> shift) & 0xFF) + div255(((dst >> shift) & 0xFF) * inv);
+        result |= std::min(channel, 255u) << shift;
+    }
+    return result;
+}
+
+void blendScalar(uint32_t* dst, const uint32_t* src, size_t count){
+    for(size_t i = 0; i < count; i++){
+        uint32_t s = src[i];
+        if(s >= 0xFF000000){
+            dst[i] = s;
+        }
+        else if(s != 0){
+            dst[i] = over(dst[i], s);
+        }
+    }
+}
+
+#ifdef COMPOSITOR_X86
+// Four pixels at once: widen to 16 bits, multiply by 255 - alpha, the same rounding division as div255,
+// then a saturating add of the source
+__attribute__((target("sse2")))
+void blendSse2(uint32_t* dst, const uint32_t* src, size_t count){
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i full = _mm_set1_epi32(255);
+    const __m128i half = _mm_set1_epi16(128);
+
+    size_t i = 0;
+    for(; i + 4 <= count; i += 4){
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(s, alpha), alpha)) == 0xFFFF){
+            _mm_storeu_si128((__m128i*)(dst + i), s);
+            continue;
+        }
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xFFFF){
+            continue;
+        }
+
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+
+        __m128i inv = _mm_sub_epi32(full, _mm_srli_epi32(s, 24));
+        inv = _mm_or_si128(inv, _mm_slli_epi32(inv, 16));
+
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(inv, inv));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(inv, inv));
+        lo = _mm_add_epi16(lo, half);
+        hi = _mm_add_epi16(hi, half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(s, _mm_packus_epi16(lo, hi)));
+    }
+
+    blendScalar(dst + i, src + i, count - i);
+}
+
+// blendSse2 eight pixels wide, the unpacks and packs work within each 128 bit lane so pixels stay in place
+__attribute__((target("avx2")))
+void blendAvx2(uint32_t* dst, const uint32_t* src, size_t count){
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i full = _mm256_set1_epi32(255);
+    const __m256i half = _mm256_set1_epi16(128);
+
+    size_t i = 0;
+    for(; i + 8 <= count; i += 8){
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_and_si256(s, alpha), alpha)) == -1){
+            _mm256_storeu_si256((__m256i*)(dst + i), s);
+            continue;
+        }
+        if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero)) == -1){
+            continue;
+        }
+
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+
+        __m256i inv = _mm256_sub_epi32(full, _mm256_srli_epi32(s, 24));
+        inv = _mm256_or_si256(inv, _mm256_slli_epi32(inv, 16));
+
+        __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(inv, inv));
+        __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(inv, inv));
+        lo = _mm256_add_epi16(lo, half);
+        hi = _mm256_add_epi16(hi, half);
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi)));
+    }
+
+    // The tail runs legacy SSE code, which stalls on dirty upper halves, and GCC leaves them dirty for a tail call
+    _mm256_zeroupper();
+    blendSse2(dst + i, src + i, count - i);
+}
+#endif
+
+sdl::Simd supported(){
+#ifdef COMPOSITOR_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        return sdl::Simd::AVX2;
+    }
+    if(__builtin_cpu_supports("sse2")){
+        return sdl::Simd::SSE2;
+    }
+#endif
+    return sdl::Simd::SCALAR;
+}
+
+sdl::Simd active = supported();
+
+// Destination pixels whose centers fall inside [from, to)
+inline int firstCovered(float from){
+    return (int)std::ceil(from - 0.5f);
+}
+}
+
+sdl::Image::Image(int width, int height)
+: width(width), height(height), pixels((size_t)width * height, 0) {}
+
+void sdl::Image::resize(int width, int height){
+    this->width = width;
+    this->height = height;
+    pixels.assign((size_t)width * height, 0);
+    opaque = false;
+}
+
+void sdl::Image::load(const uint32_t* source, int width, int height, int pitch){
+    resize(width, height);
+
+    opaque = true;
+    for(int y = 0; y < height; y++){
+        const uint32_t* in = source + (size_t)y * pitch;
+        uint32_t* out = getRow(y);
+        for(int x = 0; x < width; x++){
+            uint32_t pixel = in[x];
+            uint32_t a = pixel >> 24;
+            if(a == 255){
+                out[x] = pixel;
+                continue;
+            }
+
+            opaque = false;
+            out[x] = (a << 24) | (div255(((pixel >> 16) & 0xFF) * a) << 16) | (div255(((pixel >> 8) & 0xFF) * a) << 8) | div255((pixel & 0xFF) * a);
+        }
+    }
+}
+
+void sdl::Image::fill(uint32_t color){
+    std::fill(pixels.begin(), pixels.end(), color);
+    opaque = (color >> 24) == 255;
+}
+
+int sdl::Image::getWidth() const {
+    return width;
+}
+
+int sdl::Image::getHeight() const {
+    return height;
+}
+
+uint32_t* sdl::Image::getRow(int y){
+    return pixels.data() + (size_t)y * width;
+}
+
+const uint32_t* sdl::Image::getRow(int y) const {
+    return pixels.data() + (size_t)y * width;
+}
+
+std::vector<uint32_t>& sdl::Image::getPixels(){
+    return pixels;
+}
+
+const std::vector<uint32_t>& sdl::Image::getPixels() const {
+    return pixels;
+}
+
+bool sdl::Image::isOpaque() const {
+    return opaque;
+}
+
+void sdl::Image::setOpaque(bool opaque){
+    this->opaque = opaque;
+}
+
+void sdl::Image::unpremultiply(std::vector<uint32_t>& out) const {
+    out.resize(pixels.size());
+    for(size_t i = 0; i < pixels.size(); i++){
+        uint32_t pixel = pixels[i];
+        uint32_t a = pixel >> 24;
+        if(a == 255 || a == 0){
+            out[i] = a == 255 ? pixel : 0;
+            continue;
+        }
+
+        uint32_t result = a << 24;
+        for(int shift = 0; shift < 24; shift += 8){
+            uint32_t channel = (((pixel >> shift) & 0xFF) * 255 + a / 2) / a;
+            result |= std::min(channel, 255u) << shift;
+        }
+        out[i] = result;
+    }
+}
+
+bool sdl::Image::writeRaw(FILE* file) const {
+    if(opaque){
+        return fwrite(pixels.data(), sizeof(uint32_t), pixels.size(), file) == pixels.size();
+    }
+
+    std::vector<uint32_t> straight;
+    unpremultiply(straight);
+    return fwrite(straight.data(), sizeof(uint32_t), straight.size(), file) == straight.size();
+}
+
+void sdl::blendRow(uint32_t* dst, const uint32_t* src, size_t count){
+    switch(active){
+#ifdef COMPOSITOR_X86
+        case Simd::AVX2:
+            blendAvx2(dst, src, count);
+            return;
+        case Simd::SSE2:
+            blendSse2(dst, src, count);
+            return;
+#endif
+        default:
+            blendScalar(dst, src, count);
+            return;
+    }
+}
+
+sdl::Simd sdl::getSimd(){
+    return active;
+}
+
+void sdl::setSimd(Simd simd){
+    active = std::min(simd, supported());
+}
+
+const char* sdl::simdName(Simd simd){
+    switch(simd){
+        case Simd::SCALAR:
+            return "scalar";
+        case Simd::SSE2:
+            return "sse2";
+        case Simd::AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+sdl::Compositor::Compositor(int width, int height)
+: framebuffer(width, height), target(&framebuffer) {}
+
+void sdl::Compositor::clear(uint32_t color){
+    target->fill(color);
+    if(target == &framebuffer){
+        pixel_count = 0;
+    }
+}
+
+void sdl::Compositor::draw(const Image& source, const Blit& blit){
+    if(blit.w <= 0.0f || blit.h <= 0.0f){
+        return;
+    }
+
+    // Keep the source rect inside the image, SDL does the same with clips that hang over the edge
+    Blit clipped = blit;
+    int left = std::max(blit.clip_x, 0), top = std::max(blit.clip_y, 0);
+    int right = std::min(blit.clip_x + blit.clip_w, source.getWidth());
+    int bottom = std::min(blit.clip_y + blit.clip_h, source.getHeight());
+    if(right <= left || bottom <= top){
+        return;
+    }
+    clipped.clip_x = left;
+    clipped.clip_y = top;
+    clipped.clip_w = right - left;
+    clipped.clip_h = bottom - top;
+
+    if(std::fmod(blit.angle, 360.0f) != 0.0f){
+        drawRotated(source, clipped);
+    }
+    else {
+        drawAxisAligned(source, clipped);
+    }
+
+    // Over an opaque target every blend comes out with alpha 255 again, so the target's flag stays right
+}
+
+void sdl::Compositor::setTarget(Image* target){
+    this->target = target != nullptr ? target : &framebuffer;
+}
+
+sdl::Image& sdl::Compositor::getFramebuffer(){
+    return framebuffer;
+}
+
+const sdl::Image& sdl::Compositor::getFramebuffer() const {
+    return framebuffer;
+}
+
+uint64_t sdl::Compositor::getPixelCount() const {
+    return pixel_count;
+}
+
+void sdl::Compositor::drawAxisAligned(const Image& source, const Blit& blit){
+    int x0 = std::max(firstCovered(blit.x), 0);
+    int x1 = std::min(firstCovered(blit.x + blit.w), target->getWidth());
+    int y0 = std::max(firstCovered(blit.y), 0);
+    int y1 = std::min(firstCovered(blit.y + blit.h), target->getHeight());
+    if(x1 <= x0 || y1 <= y0){
+        return;
+    }
+
+    int count = x1 - x0;
+    double scale_x = blit.clip_w / (double)blit.w;
+    double scale_y = blit.clip_h / (double)blit.h;
+
+    // Source column of the first pixel and the step to the next one in 16.16, mirrored when flipped
+    double u = (x0 + 0.5 - blit.x) * scale_x;
+    int64_t step = (int64_t)std::llround(scale_x * 65536.0);
+    int64_t start = (int64_t)std::floor((blit.flip_x ? blit.clip_w - u : u) * 65536.0);
+    if(blit.flip_x){
+        step = -step;
+    }
+
+    int last = blit.clip_x + blit.clip_w - 1;
+    int first_column = blit.clip_x + (int)(start >> 16);
+    bool direct = !blit.flip_x && step == 65536 && first_column >= blit.clip_x && first_column + count - 1 <= last;
+
+    row.resize(count);
+    for(int y = y0; y < y1; y++){
+        double v = (y + 0.5 - blit.y) * scale_y;
+        int source_y = (int)std::floor(blit.flip_y ? blit.clip_h - v : v);
+        source_y = blit.clip_y + std::min(std::max(source_y, 0), blit.clip_h - 1);
+
+        const uint32_t* in = source.getRow(source_y);
+        uint32_t* out = target->getRow(y) + x0;
+
+        const uint32_t* span = in + first_column;
+        if(!direct){
+            int64_t position = start;
+            for(int i = 0; i < count; i++){
+                int column = blit.clip_x + (int)(position >> 16);
+                row[i] = in[std::min(std::max(column, blit.clip_x), last)];
+                position += step;
+            }
+            span = row.data();
+        }
+
+        if(source.isOpaque()){
+            memcpy(out, span, count * sizeof(uint32_t));
+        }
+        else {
+            blendRow(out, span, count);
+        }
+    }
+
+    pixel_count += (uint64_t)count * (y1 - y0);
+}
+
+void sdl::Compositor::drawRotated(const Image& source, const Blit& blit){
+    double radians = blit.angle * M_PI / 180.0;
+    double c = std::cos(radians), s = std::sin(radians);
+
+    double cx = blit.x + blit.center_x, cy = blit.y + blit.center_y;
+
+    // Bounding box of the turned rect
+    double min_x = cx, max_x = cx, min_y = cy, max_y = cy;
+    double corners[4][2] = {{0.0, 0.0}, {blit.w, 0.0}, {blit.w, blit.h}, {0.0, blit.h}};
+    for(const double* corner : corners){
+        double dx = corner[0] - blit.center_x, dy = corner[1] - blit.center_y;
+        double x = cx + dx * c - dy * s;
+        double y = cy + dx * s + dy * c;
+        min_x = std::min(min_x, x);
+        max_x = std::max(max_x, x);
+        min_y = std::min(min_y, y);
+        max_y = std::max(max_y, y);
+    }
+
+    int x0 = std::max(firstCovered(min_x), 0);
+    int x1 = std::min(firstCovered(max_x), target->getWidth());
+    int y0 = std::max(firstCovered(min_y), 0);
+    int y1 = std::min(firstCovered(max_y), target->getHeight());
+    if(x1 <= x0 || y1 <= y0){
+        return;
+    }
+
+    double scale_x = blit.clip_w / (double)blit.w;
+    double scale_y = blit.clip_h / (double)blit.h;
+
+    row.resize(x1 - x0);
+    for(int y = y0; y < y1; y++){
+        // Turned back by the angle, each pixel to the right moves (c, -s) through the unturned rect
+        double dx = x0 + 0.5 - cx, dy = y + 0.5 - cy;
+        double lx = blit.center_x + dx * c + dy * s;
+        double ly = blit.center_y - dx * s + dy * c;
+
+        int first = -1, end = 0;
+        for(int i = 0; i < x1 - x0; i++){
+            double px = lx + i * c, py = ly - i * s;
+            if(px < 0.0 || py < 0.0 || px >= blit.w || py >= blit.h){
+                row[i] = 0;
+                continue;
+            }
+
+            int u = (int)((blit.flip_x ? blit.w - px : px) * scale_x);
+            int v = (int)((blit.flip_y ? blit.h - py : py) * scale_y);
+            u = blit.clip_x + std::min(u, blit.clip_w - 1);
+            v = blit.clip_y + std::min(v, blit.clip_h - 1);
+
+            row[i] = source.getRow(v)[u];
+            if(first < 0){
+                first = i;
+            }
+            end = i + 1;
+        }
+
+        // Only the part of the row the rect crosses
+        if(first >= 0){
+            blendRow(target->getRow(y) + x0 + first, row.data() + first, end - first);
+            pixel_count += end - first;
+        }
+    }
+}
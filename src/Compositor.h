@@ -0,0 +1,111 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace sdl {
+
+// CPU image of premultiplied 0xAARRGGBB pixels, SDL_PIXELFORMAT_ARGB8888 in memory on little endian machines
+class Image
+{
+    public:
+        // Transparent black
+        Image(int width = 0, int height = 0);
+
+        void resize(int width, int height);
+
+        // Takes straight alpha ARGB rows, pitch in pixels, and premultiplies them
+        void load(const uint32_t* pixels, int width, int height, int pitch);
+
+        void fill(uint32_t color);
+
+        int getWidth() const;
+        int getHeight() const;
+
+        uint32_t* getRow(int y);
+        const uint32_t* getRow(int y) const;
+
+        std::vector<uint32_t>& getPixels();
+        const std::vector<uint32_t>& getPixels() const;
+
+        // Every pixel has alpha 255, blits from it are plain copies
+        bool isOpaque() const;
+        void setOpaque(bool opaque);
+
+        // Straight alpha copy of the pixels in the same layout, what image files expect
+        void unpremultiply(std::vector<uint32_t>& out) const;
+
+        // Appends the frame to a raw stream as straight alpha BGRA bytes, ffmpeg reads it with -f rawvideo -pix_fmt bgra
+        bool writeRaw(FILE* file) const;
+
+    private:
+        int width, height;
+        std::vector<uint32_t> pixels;
+        bool opaque = false;
+};
+
+// Where a source rect lands: the destination rect before rotation, then turned clockwise
+// around center, which is relative to (x, y), the same as SDL_RenderCopyExF
+struct Blit {
+    float x = 0.0f, y = 0.0f, w = 0.0f, h = 0.0f;
+    int clip_x = 0, clip_y = 0, clip_w = 0, clip_h = 0;
+
+    float angle = 0.0f;
+    float center_x = 0.0f, center_y = 0.0f;
+
+    bool flip_x = false, flip_y = false;
+};
+
+enum class Simd {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Premultiplied source over dst for count pixels, the same integer math on every path so all of them give
+// the same bits. Runs of fully opaque or fully transparent source are copied or skipped a vector at a time
+void blendRow(uint32_t* dst, const uint32_t* src, size_t count);
+
+// The best the CPU has unless lowered with setSimd, which clamps to what the CPU supports
+Simd getSimd();
+void setSimd(Simd simd);
+const char* simdName(Simd simd);
+
+// Software renderer for sprites: nearest sampled blits, clipped, flipped and rotated, blended with blendRow.
+// Draws into its framebuffer or into an image set as the target
+class Compositor
+{
+    public:
+        Compositor(int width, int height);
+
+        void clear(uint32_t color);
+
+        void draw(const Image& source, const Blit& blit);
+
+        // nullptr goes back to the framebuffer
+        void setTarget(Image* target);
+
+        Image& getFramebuffer();
+        const Image& getFramebuffer() const;
+
+        // Pixels written since the last clear of the framebuffer, for the frame stats
+        uint64_t getPixelCount() const;
+
+    private:
+        void drawAxisAligned(const Image& source, const Blit& blit);
+        void drawRotated(const Image& source, const Blit& blit);
+
+        Image framebuffer;
+        Image* target;
+
+        // One destination row of gathered source pixels
+        std::vector<uint32_t> row;
+
+        uint64_t pixel_count = 0;
+};
+}
+
+#endif // COMPOSITOR_H
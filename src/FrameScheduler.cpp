@@ -0,0 +1,134 @@
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "FrameScheduler.h"
+
+#include "RenderWindow.h"
+
+sdl::FrameScheduler::FrameScheduler(sdl::RenderWindow* window, FrameMode mode, int fps)
+: window(window), mode(mode), fps(fps) {
+    setMode(mode);
+}
+
+double sdl::FrameScheduler::beginFrame(){
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(!started){
+        started = true;
+        previous = now;
+        deadline = now;
+        return 0.0;
+    }
+
+    double elapsed = std::chrono::duration<double>(now - previous).count();
+    previous = now;
+
+    if(!waited){
+        record(elapsed * 1000.0);
+    }
+    waited = false;
+
+    return elapsed;
+}
+
+void sdl::FrameScheduler::endFrame(bool active){
+    if(!active && idle){
+        // Wakes on the next event without taking it off the queue
+        SDL_WaitEventTimeout(nullptr, idle_timeout);
+        waited = true;
+        deadline = std::chrono::steady_clock::now();
+        return;
+    }
+
+    if(mode != CAPPED || fps <= 0){
+        return;
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+
+    deadline += period;
+    if(deadline < now - period){
+        // Fell more than a frame behind, start counting again instead of rushing to catch up
+        deadline = now;
+        return;
+    }
+
+    if(deadline - now > SPIN_MARGIN){
+        std::this_thread::sleep_for(deadline - now - SPIN_MARGIN);
+    }
+    while(std::chrono::steady_clock::now() < deadline){
+    }
+}
+
+void sdl::FrameScheduler::setMode(FrameMode mode){
+    this->mode = mode;
+    window->setVSync(mode == VSYNC);
+    deadline = std::chrono::steady_clock::now();
+    resetStats();
+}
+
+sdl::FrameMode sdl::FrameScheduler::getMode() const {
+    return mode;
+}
+
+void sdl::FrameScheduler::setFrameRate(int fps){
+    this->fps = fps;
+    resetStats();
+}
+
+int sdl::FrameScheduler::getFrameRate() const {
+    return fps;
+}
+
+void sdl::FrameScheduler::setIdle(bool idle){
+    this->idle = idle;
+}
+
+bool sdl::FrameScheduler::isIdle() const {
+    return idle;
+}
+
+void sdl::FrameScheduler::setIdleTimeout(int milliseconds){
+    idle_timeout = milliseconds;
+}
+
+const sdl::FrameStats& sdl::FrameScheduler::getStats() const {
+    return stats;
+}
+
+void sdl::FrameScheduler::resetStats(){
+    stats = FrameStats();
+    m2 = 0.0;
+}
+
+const char* sdl::FrameScheduler::modeName(FrameMode mode){
+    switch(mode){
+        case UNLIMITED:
+            return "unlimited";
+        case VSYNC:
+            return "vsync";
+        case CAPPED:
+            return "capped";
+    }
+    return "unknown";
+}
+
+// Welford's running mean and variance
+void sdl::FrameScheduler::record(double milliseconds){
+    stats.frames++;
+    if(stats.frames == 1){
+        stats.min = stats.max = milliseconds;
+    }
+    else {
+        stats.min = std::min(stats.min, milliseconds);
+        stats.max = std::max(stats.max, milliseconds);
+    }
+
+    double delta = milliseconds - stats.mean;
+    stats.mean += delta / stats.frames;
+    m2 += delta * (milliseconds - stats.mean);
+    stats.jitter = stats.frames > 1 ? std::sqrt(m2 / (stats.frames - 1)) : 0.0;
+}
@@ -0,0 +1,80 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <SDL2/SDL.h>
+#include <chrono>
+
+#include "RenderWindow.h"
+
+namespace sdl {
+
+enum FrameMode {
+    UNLIMITED,
+    VSYNC,      // present blocks on the display refresh
+    CAPPED      // sleeps, then spins, up to a fixed frame rate
+};
+
+// Frame times in milliseconds, idle frames are left out
+struct FrameStats {
+    size_t frames = 0;
+    double mean = 0.0;
+    double jitter = 0.0;    // standard deviation of the frame time
+    double min = 0.0;
+    double max = 0.0;
+};
+
+// Paces App::run, beginFrame at the top of the loop and endFrame after display
+class FrameScheduler
+{
+    public:
+        FrameScheduler(sdl::RenderWindow* window, FrameMode mode = VSYNC, int fps = 60);
+
+        // Seconds since the previous beginFrame
+        double beginFrame();
+
+        // active = false means nothing on screen can change without input, idle mode then blocks on the event queue
+        void endFrame(bool active);
+
+        void setMode(FrameMode mode);
+
+        FrameMode getMode() const;
+
+        void setFrameRate(int fps);
+
+        int getFrameRate() const;
+
+        void setIdle(bool idle);
+
+        bool isIdle() const;
+
+        void setIdleTimeout(int milliseconds);
+
+        const FrameStats& getStats() const;
+
+        void resetStats();
+
+        static const char* modeName(FrameMode mode);
+
+    private:
+        void record(double milliseconds);
+
+        sdl::RenderWindow* window;
+
+        FrameMode mode;
+        int fps;
+        bool idle = true;
+        int idle_timeout = 250;
+
+        std::chrono::steady_clock::time_point previous;
+        std::chrono::steady_clock::time_point deadline;
+        bool started = false, waited = false;
+
+        FrameStats stats;
+        double m2 = 0.0;
+
+        // Sleeping overshoots by up to a scheduler tick, the last stretch is spun instead
+        const std::chrono::microseconds SPIN_MARGIN = std::chrono::microseconds(2000);
+};
+}
+
+#endif // FRAMESCHEDULER_H
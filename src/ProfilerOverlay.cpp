@@ -0,0 +1,125 @@
+#include "ProfilerOverlay.h"
+
+#ifdef PROFILING
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "RenderWindow.h"
+#include "Sprite.h"
+#include "TexturePool.h"
+#include "sim/Profiler.h"
+
+sdl::ProfilerOverlay::ProfilerOverlay(sdl::RenderWindow* window)
+: window(window) {}
+
+sdl::ProfilerOverlay::~ProfilerOverlay(){
+    window->getTexturePool()->destroy(texture);
+
+    if(font != nullptr){
+        TTF_CloseFont(font);
+        font = nullptr;
+    }
+}
+
+bool sdl::ProfilerOverlay::open(const std::vector<std::string>& fonts, int size){
+    if(font != nullptr){
+        TTF_CloseFont(font);
+        font = nullptr;
+    }
+
+    for(const std::string& path : fonts){
+        font = TTF_OpenFont(path.c_str(), size);
+        if(font != nullptr){
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sdl::ProfilerOverlay::isOpen() const {
+    return font != nullptr;
+}
+
+void sdl::ProfilerOverlay::toggle(){
+    visible = !visible && font != nullptr;
+    refreshed = std::chrono::steady_clock::time_point();
+}
+
+bool sdl::ProfilerOverlay::isVisible() const {
+    return visible;
+}
+
+void sdl::ProfilerOverlay::update(){
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(!visible || now - refreshed < REFRESH){
+        return;
+    }
+    refreshed = now;
+
+    std::vector<std::string> lines = {"phase               min      avg      p99"};
+    char line[128];
+    for(const sim::PhaseStats& phase : sim::Profiler::get().stats()){
+        if(phase.counter){
+            snprintf(line, sizeof(line), "%-16s %7.0f  %7.2f  %7.0f", phase.name.c_str(), phase.min, phase.avg, phase.p99);
+        }
+        else {
+            snprintf(line, sizeof(line), "%-16s %6.3fms %6.3fms %6.3fms", phase.name.c_str(), phase.min, phase.avg, phase.p99);
+        }
+        lines.push_back(line);
+    }
+
+    // TTF renders a single line at a time, stack them into one surface
+    std::vector<SDL_Surface*> rendered;
+    int width = 0, height = 0;
+    SDL_Color white = {0xFF, 0xFF, 0xFF, 0xFF};
+    for(const std::string& text : lines){
+        SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), white);
+        if(surface == nullptr){
+            continue;
+        }
+        width = std::max(width, surface->w);
+        height += surface->h;
+        rendered.push_back(surface);
+    }
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, width + MARGIN * 2, height + MARGIN * 2, 32, SDL_PIXELFORMAT_RGBA32);
+    if(sheet != nullptr){
+        SDL_FillRect(sheet, nullptr, SDL_MapRGBA(sheet->format, 0, 0, 0, 0xA0));
+
+        int y = MARGIN;
+        for(SDL_Surface* surface : rendered){
+            SDL_Rect to = {MARGIN, y, surface->w, surface->h};
+            SDL_BlitSurface(surface, nullptr, sheet, &to);
+            y += surface->h;
+        }
+
+        // The freed slot is the one taken again, only the generation changes
+        window->getTexturePool()->destroy(texture);
+        texture = window->getTexturePool()->loadFromSurface(sheet);
+        sprite.setTexture(texture);
+        sprite.setPosition(0, 0);
+        SDL_FreeSurface(sheet);
+    }
+
+    for(SDL_Surface* surface : rendered){
+        SDL_FreeSurface(surface);
+    }
+}
+
+void sdl::ProfilerOverlay::render(){
+    if(visible && !texture.isNull()){
+        window->render(sprite);
+    }
+}
+
+SDL_Rect sdl::ProfilerOverlay::getBounds() const {
+    return {0, 0, texture.width, texture.height};
+}
+
+#endif // PROFILING
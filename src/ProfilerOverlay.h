@@ -0,0 +1,60 @@
+#ifndef PROFILEROVERLAY_H
+#define PROFILEROVERLAY_H
+
+#include "sim/Profiler.h"
+
+#ifdef PROFILING
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "RenderWindow.h"
+#include "Sprite.h"
+#include "TexturePool.h"
+
+namespace sdl {
+
+// min / avg / p99 of every profiled phase, drawn in the top left corner
+class ProfilerOverlay
+{
+    public:
+        ProfilerOverlay(sdl::RenderWindow* window);
+
+        ~ProfilerOverlay();
+
+        // Tries each font in turn after closing the current one, the overlay stays off when none opens
+        bool open(const std::vector<std::string>& fonts, int size = 12);
+
+        bool isOpen() const;
+
+        void toggle();
+
+        bool isVisible() const;
+
+        // Rebuilds the text at most every REFRESH, stats over the whole ring are not free
+        void update();
+
+        void render();
+
+        SDL_Rect getBounds() const;
+
+    private:
+        sdl::RenderWindow* window;
+        TTF_Font* font = nullptr;
+        sdl::TextureHandle texture;
+        sdl::Sprite sprite;
+
+        bool visible = false;
+        std::chrono::steady_clock::time_point refreshed;
+
+        const std::chrono::milliseconds REFRESH = std::chrono::milliseconds(250);
+        const int MARGIN = 4;
+};
+}
+
+#endif // PROFILING
+
+#endif // PROFILEROVERLAY_H
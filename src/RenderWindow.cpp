@@ -1,55 +1,364 @@
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <cstdio>
+#include <string>
+#include <vector>
 
 #include "RenderWindow.h"
 
+#include "Compositor.h"
 #include "Sprite.h"
 #include "Vector2f.h"
 #include "Texture.h"
+#include "SpriteBatch.h"
+#include "TextureCache.h"
+#include "TexturePool.h"
 
-sdl::RenderWindow::RenderWindow(const std::string title, const int width, const int height) : title(title), size(width, height) {
+namespace {
+
+// Splits a pattern like frame%04d.png around its one integer conversion, %d with an optional width of up
+// to two digits, optionally zero padded, and turns %% into %. False for no conversion, several or any other,
+// so the pattern itself never reaches printf
+bool splitPattern(const std::string& pattern, std::string& prefix, std::string& conversion, std::string& suffix){
+    prefix.clear();
+    conversion.clear();
+    suffix.clear();
+
+    bool found = false;
+    for(size_t i = 0; i < pattern.size(); i++){
+        std::string& out = found ? suffix : prefix;
+        if(pattern[i] != '%'){
+            out += pattern[i];
+            continue;
+        }
+
+        if(i + 1 < pattern.size() && pattern[i + 1] == '%'){
+            out += '%';
+            i++;
+            continue;
+        }
+
+        size_t end = i + 1;
+        if(end < pattern.size() && pattern[end] == '0'){
+            end++;
+        }
+        size_t width = end;
+        while(end < pattern.size() && end - width < 2 && pattern[end] >= '0' && pattern[end] <= '9'){
+            end++;
+        }
+        if(found || end >= pattern.size() || pattern[end] != 'd'){
+            return false;
+        }
+
+        conversion = pattern.substr(i, end - i + 1);
+        found = true;
+        i = end;
+    }
+
+    return found;
+}
+}
+
+sdl::RenderWindow::RenderWindow(const std::string title, const int width, const int height, bool offscreen) : title(title), size(width, height) {
+    if(offscreen){
+        window = nullptr;
+        renderer = nullptr;
+        batch = nullptr;
+        compositor = new sdl::Compositor(width, height);
+        pool = new sdl::TexturePool(nullptr);
+        textures = new sdl::TextureCache(*pool);
+        return;
+    }
+
+    compositor = nullptr;
     window = SDL_CreateWindow(title.c_str(), SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_SHOWN);
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if(renderer == nullptr){
+        // Headless boxes and the dummy video driver only have the software renderer
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    }
+    batch = new sdl::SpriteBatch(renderer);
+    pool = new sdl::TexturePool(renderer);
+    textures = new sdl::TextureCache(*pool);
+
+    SDL_RendererInfo info;
+    if(SDL_GetRendererInfo(renderer, &info) == 0){
+        software = info.flags & SDL_RENDERER_SOFTWARE;
+    }
 }
 
 sdl::RenderWindow::~RenderWindow(){
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    if(capture_stream != nullptr && capture_stream != stdout){
+        fclose(capture_stream);
+    }
+    capture_stream = nullptr;
+
+    delete batch;
+    batch = nullptr;
+    delete compositor;
+    compositor = nullptr;
+
+    // Textures go before the renderer that owns them
+    delete textures;
+    textures = nullptr;
+    delete pool;
+    pool = nullptr;
+
+    if(renderer != nullptr){
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+    }
 
     renderer = nullptr;
     window = nullptr;
 }
 
-void sdl::RenderWindow::clear(){
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_RenderClear(renderer);
+void sdl::RenderWindow::clear(bool fill){
+    frame_draw_calls = 0;
+    frame_vertex_count = 0;
+
+    if(compositor != nullptr){
+        if(fill){
+            compositor->clear(0xFFFFFFFF);
+        }
+        return;
+    }
+
+    batch->begin();
+
+    if(fill){
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(renderer);
+    }
 }
 
 void sdl::RenderWindow::render(sdl::Sprite& sprite){
+    // A stale handle draws nothing rather than whatever reused the slot
+    sdl::Texture* texture = pool->get(sprite.getTexture());
+    if(texture == nullptr){
+        return;
+    }
+
+    if(compositor != nullptr){
+        render(sprite, *texture);
+        return;
+    }
+
+    if(batching){
+        batch->draw(sprite, texture->getTexture());
+        return;
+    }
+
+    frame_draw_calls++;
+    frame_vertex_count += 4;
+
     SDL_FRect rect;
     rect.x = sprite.getPosition().x;
     rect.y = sprite.getPosition().y;
     rect.w = sprite.getScale().x;
     rect.h = sprite.getScale().y;
     
-    SDL_RenderCopyExF(renderer, sprite.getTexture()->getTexture(), sprite.getClip(), &rect, sprite.getAngle(), sprite.getRotationCenter(), sprite.getFlip());
+    SDL_RenderCopyExF(renderer, texture->getTexture(), sprite.getClip(), &rect, sprite.getAngle(), sprite.getRotationCenter(), sprite.getFlip());
 }
 
-sdl::Texture* sdl::RenderWindow::loadTextureFromFile(const std::string path){
-    sdl::Texture* texture = new sdl::Texture(renderer);
-    if(!texture->loadFromFile(path)){
-        throw std::runtime_error("Failed to load texture from file");
+void sdl::RenderWindow::render(sdl::Sprite& sprite, sdl::Texture& texture){
+    const sdl::Image* image = texture.getImage();
+    if(image == nullptr){
+        return;
     }
-    return texture;
+
+    frame_draw_calls++;
+    frame_vertex_count += 4;
+
+    // The same rect, clip, angle and center SDL_RenderCopyExF gets
+    sdl::Blit blit;
+    blit.x = sprite.getPosition().x;
+    blit.y = sprite.getPosition().y;
+    blit.w = sprite.getScale().x;
+    blit.h = sprite.getScale().y;
+
+    SDL_Rect* clip = sprite.getClip();
+    blit.clip_x = clip != nullptr ? clip->x : 0;
+    blit.clip_y = clip != nullptr ? clip->y : 0;
+    blit.clip_w = clip != nullptr ? clip->w : image->getWidth();
+    blit.clip_h = clip != nullptr ? clip->h : image->getHeight();
+
+    SDL_FPoint* center = sprite.getRotationCenter();
+    blit.angle = sprite.getAngle();
+    blit.center_x = center != nullptr ? center->x : blit.w / 2.0f;
+    blit.center_y = center != nullptr ? center->y : blit.h / 2.0f;
+
+    blit.flip_x = sprite.getFlip() & SDL_FLIP_HORIZONTAL;
+    blit.flip_y = sprite.getFlip() & SDL_FLIP_VERTICAL;
+
+    compositor->draw(*image, blit);
+}
+
+sdl::TextureHandle sdl::RenderWindow::loadTextureFromFile(const std::string& path){
+    return textures->acquire(path);
+}
+
+sdl::TextureHandle sdl::RenderWindow::loadTextureFromSurface(const std::string& path, SDL_Surface* surface){
+    return textures->acquire(path, surface);
+}
+
+void sdl::RenderWindow::releaseTexture(sdl::TextureHandle texture){
+    textures->release(texture);
+}
+
+sdl::Texture* sdl::RenderWindow::getTexture(sdl::TextureHandle texture){
+    return pool->get(texture);
+}
+
+sdl::TextureCache* sdl::RenderWindow::getTextureCache() const {
+    return textures;
+}
+
+sdl::TexturePool* sdl::RenderWindow::getTexturePool() const {
+    return pool;
 }
 
 void sdl::RenderWindow::display(){
+    if(compositor != nullptr){
+        draw_calls = frame_draw_calls;
+        vertex_count = frame_vertex_count;
+        capture();
+        return;
+    }
+
+    flush();
+
+    draw_calls = frame_draw_calls + batch->getDrawCalls();
+    vertex_count = frame_vertex_count + batch->getVertexCount();
+
     SDL_RenderPresent(renderer);
 }
 
+void sdl::RenderWindow::flush(){
+    if(batch != nullptr){
+        batch->flush();
+    }
+}
+
+void sdl::RenderWindow::setTarget(sdl::TextureHandle texture){
+    flush();
+    sdl::Texture* target = pool->get(texture);
+    if(compositor != nullptr){
+        compositor->setTarget(target != nullptr ? target->getImage() : nullptr);
+        return;
+    }
+    SDL_SetRenderTarget(renderer, target != nullptr ? target->getTexture() : nullptr);
+}
+
+void sdl::RenderWindow::setVSync(bool vsync){
+    if(renderer != nullptr){
+        SDL_RenderSetVSync(renderer, vsync ? 1 : 0);
+    }
+}
+
+bool sdl::RenderWindow::setCapture(const std::string& path){
+    if(compositor == nullptr){
+        return false;
+    }
+
+    if(capture_stream != nullptr && capture_stream != stdout){
+        fclose(capture_stream);
+    }
+    capture_stream = nullptr;
+    capture_path = path;
+    capture_frame = 0;
+
+    if(path == "-"){
+        capture_stream = stdout;
+    }
+    else if(path.size() > 4 && path.compare(path.size() - 4, 4, ".raw") == 0){
+        capture_stream = fopen(path.c_str(), "wb");
+        if(capture_stream == nullptr){
+            capture_path.clear();
+            return false;
+        }
+    }
+    // Without a number every frame would overwrite the last
+    else if(!splitPattern(path, capture_prefix, capture_conversion, capture_suffix)){
+        SDL_Log("Capture path %s needs exactly one %%d for the frame number, %% is written %%%%", path.c_str());
+        capture_path.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void sdl::RenderWindow::capture(){
+    if(capture_path.empty()){
+        return;
+    }
+
+    const sdl::Image& frame = compositor->getFramebuffer();
+
+    if(capture_stream != nullptr){
+        if(!frame.writeRaw(capture_stream)){
+            SDL_Log("Failed to write frame %d to %s", capture_frame, capture_path.c_str());
+            capture_path.clear();
+        }
+        capture_frame++;
+        return;
+    }
+
+    // splitPattern let nothing but a lone %d with a width through
+    char number[32];
+    snprintf(number, sizeof(number), capture_conversion.c_str(), capture_frame);
+    std::string path = capture_prefix + number + capture_suffix;
+
+    // SDL wants straight alpha, which for the usual opaque frame is the framebuffer as it is
+    frame.unpremultiply(capture_pixels);
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(capture_pixels.data(), frame.getWidth(), frame.getHeight(), 32,
+                                                              frame.getWidth() * 4, SDL_PIXELFORMAT_ARGB8888);
+    if(surface == nullptr || IMG_SavePNG(surface, path.c_str()) != 0){
+        SDL_Log("Failed to write frame %s: %s", path.c_str(), SDL_GetError());
+        capture_path.clear();
+    }
+    SDL_FreeSurface(surface);
+    capture_frame++;
+}
+
+void sdl::RenderWindow::setBatching(bool batching){
+    flush();
+    this->batching = batching;
+}
+
+bool sdl::RenderWindow::isBatching() const {
+    return batching;
+}
+
+int sdl::RenderWindow::getDrawCalls() const {
+    return draw_calls;
+}
+
+int sdl::RenderWindow::getVertexCount() const {
+    return vertex_count;
+}
+
+bool sdl::RenderWindow::isSoftware() const {
+    return software;
+}
+
+bool sdl::RenderWindow::keepsFrame() const {
+    // Nothing but our own draws ever touches the compositor's framebuffer
+    return compositor != nullptr;
+}
+
+bool sdl::RenderWindow::isOffscreen() const {
+    return compositor != nullptr;
+}
+
 SDL_Renderer* sdl::RenderWindow::getRenderer() const {
     return renderer;
 }
 
+sdl::Compositor* sdl::RenderWindow::getCompositor() const {
+    return compositor;
+}
+
 int sdl::RenderWindow::getWidth() const {
     return size.x;
 }
@@ -5,8 +5,15 @@
 #include <SDL2/SDL_image.h>
 #include <SDL2/SDL_mixer.h>
 #include <SDL2/SDL_ttf.h>
+#include <cstdio>
+#include <string>
+#include <vector>
 
+#include "Compositor.h"
 #include "Sprite.h"
+#include "SpriteBatch.h"
+#include "TextureCache.h"
+#include "TexturePool.h"
 #include "Vector2f.h"
 
 namespace sdl {
@@ -21,30 +28,106 @@ enum sdlModules {
 class RenderWindow
 {
     public:
-        RenderWindow(const std::string title, const int width, const int height);
+        // offscreen opens no window and no renderer, sprites are composited on the CPU into a framebuffer
+        // that is only seen through setCapture. Textures then hold sdl::Images instead of SDL textures
+        RenderWindow(const std::string title, const int width, const int height, bool offscreen = false);
         
         ~RenderWindow();
 
-        void clear();
+        // fill = false keeps the previous frame, for redrawing only parts of it
+        void clear(bool fill = true);
 
         void render(sdl::Sprite& sprite);
 
-        sdl::Texture* loadTextureFromFile(const std::string path);
+        // Shared per path, every call takes a reference the caller gives back with releaseTexture
+        sdl::TextureHandle loadTextureFromFile(const std::string& path);
+
+        // Uploads a surface decoded off the render thread, cached under path
+        sdl::TextureHandle loadTextureFromSurface(const std::string& path, SDL_Surface* surface);
+
+        void releaseTexture(sdl::TextureHandle texture);
+
+        // nullptr once the texture is gone
+        sdl::Texture* getTexture(sdl::TextureHandle texture);
+
+        sdl::TextureCache* getTextureCache() const;
+
+        // Uncached textures like render targets, created and destroyed by their single owner
+        sdl::TexturePool* getTexturePool() const;
 
         void display();
 
+        // Submits queued sprites, needed before drawing straight to the renderer
+        void flush();
+
+        // Renders into texture until called again with a null handle
+        void setTarget(sdl::TextureHandle texture);
+
+        // Needs SDL 2.0.18, older versions keep whatever the renderer was created with
+        void setVSync(bool vsync);
+
+        // Offscreen only, writes every displayed frame. A path ending in .raw, or - for stdout, is one stream of
+        // straight alpha BGRA frames, anything else names PNG files numbered from 0 with exactly one %d, which
+        // may have a width of up to two digits, optionally zero padded, like %4d or %04d. %% is a literal %.
+        // False for any other pattern
+        bool setCapture(const std::string& path);
+
+        void setBatching(bool batching);
+
+        bool isBatching() const;
+
+        // Counts for the last displayed frame
+        int getDrawCalls() const;
+
+        int getVertexCount() const;
+
+        // SDL's software renderer, which in practice keeps the window surface between frames. SDL documents
+        // the backbuffer as undefined after present though, so nothing may rely on that without opting in
+        bool isSoftware() const;
+
+        // The previous frame is guaranteed to still be there after display, only offscreen
+        bool keepsFrame() const;
+
+        bool isOffscreen() const;
+
+        // nullptr when offscreen
         SDL_Renderer* getRenderer() const;
 
+        // nullptr unless offscreen
+        sdl::Compositor* getCompositor() const;
+
         int getWidth() const;
 
         int getHeight() const;
 
     private:
+        // Offscreen path of render
+        void render(sdl::Sprite& sprite, sdl::Texture& texture);
+
+        void capture();
+
         std::string title;
         math::Vector2f size;
 
         SDL_Window* window;
         SDL_Renderer* renderer;
+
+        sdl::SpriteBatch* batch;
+        sdl::Compositor* compositor;
+        sdl::TexturePool* pool;
+        sdl::TextureCache* textures;
+        bool batching = true;
+        bool software = false;
+
+        int draw_calls = 0, vertex_count = 0;
+        int frame_draw_calls = 0, frame_vertex_count = 0;
+
+        // Where displayed frames go, either one open stream or numbered files
+        std::string capture_path;
+        std::string capture_prefix, capture_conversion, capture_suffix;
+        FILE* capture_stream = nullptr;
+        int capture_frame = 0;
+        std::vector<uint32_t> capture_pixels;
 };
 
 inline bool initSDL(int flags = SDL_INIT_EVERYTHING, int modules = SDL_ALL, int imgFlags = IMG_INIT_PNG){
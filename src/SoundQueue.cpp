@@ -0,0 +1,109 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <algorithm>
+#include <vector>
+
+#include "SoundQueue.h"
+
+sdl::SoundQueue::SoundQueue(int voices)
+: voices(voices) {
+    Mix_AllocateChannels(voices);
+}
+
+void sdl::SoundQueue::push(Mix_Chunk* chunk, int volume){
+    if(chunk == nullptr){
+        return;
+    }
+    pending.push_back({chunk, std::max(0, std::min(volume, MIX_MAX_VOLUME))});
+}
+
+void sdl::SoundQueue::drain(){
+    played = merged = stolen = 0;
+    if(pending.empty()){
+        return;
+    }
+
+    Uint32 now = SDL_GetTicks();
+
+    for(size_t i = 0; i < pending.size(); i++){
+        Request request = pending[i];
+        if(request.chunk == nullptr){
+            continue;
+        }
+
+        // Everything else this frame with the same sound rides along at the loudest volume
+        for(size_t j = i + 1; j < pending.size(); j++){
+            if(pending[j].chunk == request.chunk){
+                request.volume = std::max(request.volume, pending[j].volume);
+                pending[j].chunk = nullptr;
+                merged++;
+            }
+        }
+
+        // Still within the window of the same sound started earlier, raise that voice instead of stacking another
+        bool joined = false;
+        for(size_t v = 0; v < voices.size(); v++){
+            Voice& voice = voices[v];
+            if(voice.chunk == request.chunk && now - voice.started < MERGE_WINDOW && Mix_Playing(v)){
+                if(request.volume > voice.volume){
+                    voice.volume = request.volume;
+                    Mix_Volume(v, voice.volume);
+                }
+                merged++;
+                joined = true;
+                break;
+            }
+        }
+        if(joined){
+            continue;
+        }
+
+        int channel = pick(now);
+        Mix_Volume(channel, request.volume);
+        if(Mix_PlayChannel(channel, request.chunk, 0) == -1){
+            continue;
+        }
+
+        voices[channel] = {request.chunk, now, request.volume};
+        played++;
+    }
+
+    pending.clear();
+}
+
+// First idle voice, otherwise the one that has been playing longest
+int sdl::SoundQueue::pick(Uint32 now){
+    int oldest = 0;
+    for(size_t v = 0; v < voices.size(); v++){
+        if(!Mix_Playing(v)){
+            return v;
+        }
+        if(now - voices[v].started > now - voices[oldest].started){
+            oldest = v;
+        }
+    }
+
+    Mix_HaltChannel(oldest);
+    stolen++;
+    return oldest;
+}
+
+void sdl::SoundQueue::clear(){
+    pending.clear();
+}
+
+int sdl::SoundQueue::getVoices() const {
+    return voices.size();
+}
+
+int sdl::SoundQueue::getPlayed() const {
+    return played;
+}
+
+int sdl::SoundQueue::getMerged() const {
+    return merged;
+}
+
+int sdl::SoundQueue::getStolen() const {
+    return stolen;
+}
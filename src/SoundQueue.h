@@ -0,0 +1,58 @@
+#ifndef SOUNDQUEUE_H
+#define SOUNDQUEUE_H
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_mixer.h>
+#include <vector>
+
+namespace sdl {
+
+// Collects the sounds gameplay asks for during a frame and hands them to the mixer in one go.
+// Repeats of a sound within MERGE_WINDOW collapse into one play at the loudest volume,
+// and a fixed set of voices caps how much the mixer has to mix, the oldest one is cut off when all are busy
+class SoundQueue
+{
+    public:
+        SoundQueue(int voices = 8);
+
+        // volume 0 to MIX_MAX_VOLUME, set on the voice that plays it only
+        void push(Mix_Chunk* chunk, int volume = MIX_MAX_VOLUME);
+
+        // Once per frame
+        void drain();
+
+        void clear();
+
+        int getVoices() const;
+
+        // Counts since the last drain
+        int getPlayed() const;
+
+        int getMerged() const;
+
+        int getStolen() const;
+
+        static constexpr Uint32 MERGE_WINDOW = 50;  // ms
+
+    private:
+        struct Request {
+            Mix_Chunk* chunk;
+            int volume;
+        };
+
+        struct Voice {
+            Mix_Chunk* chunk = nullptr;
+            Uint32 started = 0;
+            int volume = 0;
+        };
+
+        int pick(Uint32 now);
+
+        std::vector<Request> pending;
+        std::vector<Voice> voices;
+
+        int played = 0, merged = 0, stolen = 0;
+};
+}
+
+#endif // SOUNDQUEUE_H
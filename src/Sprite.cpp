@@ -3,22 +3,16 @@
 #include "Sprite.h"
 
 #include "Vector2f.h"
-#include "Texture.h"
+#include "TexturePool.h"
 
 sdl::Sprite::Sprite()
-: texture(nullptr), scale(0, 0), position(0, 0), flip(SDL_FLIP_NONE), angle(0), center(nullptr), clip(nullptr) {}
+: texture(), scale(0, 0), position(0, 0), flip(SDL_FLIP_NONE), angle(0), center{0, 0}, clip{0, 0, 0, 0}, region{0, 0, 0, 0}, centered(false), clipped(false), regioned(false) {}
 
-sdl::Sprite::Sprite(sdl::Texture *texture)
-: texture(texture), scale(texture->getWidth(), texture->getHeight()), position(0, 0), flip(SDL_FLIP_NONE), angle(0), center(nullptr), clip(nullptr) {}
+sdl::Sprite::Sprite(sdl::TextureHandle texture)
+: texture(texture), scale(texture.width, texture.height), position(0, 0), flip(SDL_FLIP_NONE), angle(0), center{0, 0}, clip{0, 0, 0, 0}, region{0, 0, 0, 0}, centered(false), clipped(false), regioned(false) {}
 
-sdl::Sprite::Sprite(sdl::Texture *texture, math::Vector2f position)
-: texture(texture), scale(texture->getWidth(), texture->getHeight()), position(position), flip(SDL_FLIP_NONE), angle(0), center(nullptr), clip(nullptr) {}
-
-sdl::Sprite::~Sprite(){
-    texture = nullptr;
-    center = nullptr;
-    clip = nullptr;
-}
+sdl::Sprite::Sprite(sdl::TextureHandle texture, math::Vector2f position)
+: texture(texture), scale(texture.width, texture.height), position(position), flip(SDL_FLIP_NONE), angle(0), center{0, 0}, clip{0, 0, 0, 0}, region{0, 0, 0, 0}, centered(false), clipped(false), regioned(false) {}
 
 sdl::sdlDirection sdl::Sprite::collidesWith(Sprite& other){
     if(position.x >= other.position.x + other.scale.x ||
@@ -49,9 +43,21 @@ sdl::sdlDirection sdl::Sprite::collidesWith(Sprite& other){
     }
 }
 
-void sdl::Sprite::setTexture(sdl::Texture* texture){
+void sdl::Sprite::setTexture(sdl::TextureHandle texture){
+    if(regioned){
+        regioned = false;
+        clipped = false;
+    }
     this->texture = texture;
-    setScale(texture->getWidth(), texture->getHeight());
+    setScale(texture.width, texture.height);
+}
+
+void sdl::Sprite::setTexture(sdl::TextureHandle texture, const SDL_Rect& region){
+    this->texture = texture;
+    this->region = region;
+    regioned = true;
+    setClip(0, 0, region.w, region.h);
+    setScale(region.w, region.h);
 }
 
 void sdl::Sprite::setScale(math::Vector2f scale){
@@ -80,35 +86,39 @@ void sdl::Sprite::setAngle(float angle){
     this->angle = angle;
 }
 
-void sdl::Sprite::setRotationCenter(SDL_FPoint* center){
-    if(this->center == nullptr)
-        this->center = new SDL_FPoint();
-    this->center = center;
+void sdl::Sprite::setRotationCenter(const SDL_FPoint* center){
+    centered = center != nullptr;
+    if(centered)
+        this->center = *center;
 }
 
 void sdl::Sprite::setRotationCenter(int x, int y){
-    if(this->center == nullptr)
-        this->center = new SDL_FPoint();
-    this->center->x = x;
-    this->center->y = y;
-}
-
-void sdl::Sprite::setClip(SDL_Rect* clip){
-    if(this->clip == nullptr)
-        this->clip = new SDL_Rect();
-    this->clip = clip;
+    centered = true;
+    this->center.x = x;
+    this->center.y = y;
+}
+
+void sdl::Sprite::setClip(const SDL_Rect* clip){
+    // Texture coordinates as given, unlike the int overload. A region always draws through
+    // a clip, so clearing goes back to the whole region
+    if(clip == nullptr){
+        clipped = regioned;
+        this->clip = region;
+        return;
+    }
+    clipped = true;
+    this->clip = *clip;
 }
 
 void sdl::Sprite::setClip(int x, int y, int w, int h){
-    if(this->clip == nullptr)
-        this->clip = new SDL_Rect();
-    this->clip->x = x;
-    this->clip->y = y;
-    this->clip->w = w;
-    this->clip->h = h;
+    clipped = true;
+    this->clip.x = regioned ? region.x + x : x;
+    this->clip.y = regioned ? region.y + y : y;
+    this->clip.w = w;
+    this->clip.h = h;
 }
 
-sdl::Texture* sdl::Sprite::getTexture(){
+sdl::TextureHandle sdl::Sprite::getTexture() const {
     return texture;
 }
 
@@ -117,7 +127,10 @@ math::Vector2f& sdl::Sprite::getScale(){
 }
 
 math::Vector2f sdl::Sprite::getRawScale(){
-    return math::Vector2f(texture->getWidth(), texture->getHeight());
+    if(regioned){
+        return math::Vector2f(region.w, region.h);
+    }
+    return math::Vector2f(texture.width, texture.height);
 }
 
 math::Vector2f& sdl::Sprite::getPosition(){
@@ -133,11 +146,19 @@ float sdl::Sprite::getAngle(){
 }
 
 SDL_FPoint* sdl::Sprite::getRotationCenter(){
-    return center;
+    return centered ? &center : nullptr;
 }
 
 SDL_Rect* sdl::Sprite::getClip(){
-    return clip;
+    return clipped ? &clip : nullptr;
+}
+
+bool sdl::Sprite::hasRegion() const {
+    return regioned;
+}
+
+const SDL_Rect& sdl::Sprite::getRegion() const {
+    return region;
 }
 
 math::Vector2f sdl::Sprite::getCenter() {
@@ -2,9 +2,10 @@
 #define SPRITE_H
 
 #include <SDL2/SDL.h>
+#include <type_traits>
 
 #include "Vector2f.h"
-#include "Texture.h"
+#include "TexturePool.h"
 
 namespace sdl {
 
@@ -16,20 +17,23 @@ enum sdlDirection {
     SDL_RIGHT = 3
 };
 
+// Plain value, the texture is a handle and the optional clip and center live inline,
+// so copying a sprite is a memcpy and nothing about it ever touches the heap
 class Sprite
 {
     public:
         Sprite();
 
-        Sprite(sdl::Texture *texture);
+        Sprite(sdl::TextureHandle texture);
 
-        Sprite(sdl::Texture *texture, math::Vector2f position);
-
-        ~Sprite();
+        Sprite(sdl::TextureHandle texture, math::Vector2f position);
 
         sdlDirection collidesWith(Sprite& other);
 
-        void setTexture(sdl::Texture* texture);
+        void setTexture(sdl::TextureHandle texture);
+
+        // Uses a sub-rect of a shared texture, clips and raw scale become relative to it
+        void setTexture(sdl::TextureHandle texture, const SDL_Rect& region);
 
         void setScale(math::Vector2f scale);
 
@@ -43,15 +47,17 @@ class Sprite
 
         void setAngle(float angle);
 
-        void setRotationCenter(SDL_FPoint* center);
+        // Copied, nullptr goes back to the center of the sprite
+        void setRotationCenter(const SDL_FPoint* center);
 
         void setRotationCenter(int x, int y);
 
-        void setClip(SDL_Rect* clip);
+        // Copied in texture coordinates, nullptr goes back to the whole texture or region
+        void setClip(const SDL_Rect* clip);
 
         void setClip(int x, int y, int w, int h);
 
-        Texture* getTexture();
+        sdl::TextureHandle getTexture() const;
 
         math::Vector2f& getScale();
 
@@ -63,21 +69,32 @@ class Sprite
 
         float getAngle();
 
+        // nullptr when unset, otherwise points into the sprite
         SDL_FPoint* getRotationCenter();
 
         SDL_Rect* getClip();
 
+        bool hasRegion() const;
+
+        const SDL_Rect& getRegion() const;
+
         math::Vector2f getCenter();
 
         protected:
-            sdl::Texture* texture;
+            sdl::TextureHandle texture;
             math::Vector2f scale;
             math::Vector2f position;
             SDL_RendererFlip flip;
             float angle;
-            SDL_FPoint* center;
-            SDL_Rect* clip;
+            SDL_FPoint center;
+            SDL_Rect clip;
+            SDL_Rect region;
+            bool centered;
+            bool clipped;
+            bool regioned;
 };
+
+static_assert(std::is_trivially_copyable<Sprite>::value, "Sprite is copied around by value");
 }
 
 #endif // SPRITE_H
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <SDL2/SDL.h>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "SpriteBatch.h"
+
+#include "Sprite.h"
+#include "Texture.h"
+
+sdl::SpriteBatch::SpriteBatch(SDL_Renderer* renderer)
+: renderer(renderer), texture(nullptr) {}
+
+void sdl::SpriteBatch::begin(){
+    vertices.clear();
+    indices.clear();
+    texture = nullptr;
+
+    draw_calls = 0;
+    vertex_count = 0;
+    sprite_count = 0;
+}
+
+void sdl::SpriteBatch::draw(sdl::Sprite& sprite, SDL_Texture* sprite_texture){
+    if(sprite_texture != texture){
+        flush();
+        texture = sprite_texture;
+    }
+
+    float x = sprite.getPosition().x;
+    float y = sprite.getPosition().y;
+    float w = sprite.getScale().x;
+    float h = sprite.getScale().y;
+
+    // Texture coordinates of the clip, the whole texture without one
+    float tw = sprite.getTexture().width;
+    float th = sprite.getTexture().height;
+    float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+    if(sprite.getClip() != nullptr){
+        SDL_Rect* clip = sprite.getClip();
+        u0 = clip->x / tw;
+        v0 = clip->y / th;
+        u1 = (clip->x + clip->w) / tw;
+        v1 = (clip->y + clip->h) / th;
+    }
+
+    if(sprite.getFlip() & SDL_FLIP_HORIZONTAL){
+        std::swap(u0, u1);
+    }
+    if(sprite.getFlip() & SDL_FLIP_VERTICAL){
+        std::swap(v0, v1);
+    }
+
+    float corners[4][2] = {{0.0f, 0.0f}, {w, 0.0f}, {w, h}, {0.0f, h}};
+    float uvs[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    // Clockwise around the rotation center, the rect center by default like SDL_RenderCopyExF
+    if(sprite.getAngle() != 0.0f){
+        float cx = w / 2.0f, cy = h / 2.0f;
+        if(sprite.getRotationCenter() != nullptr){
+            cx = sprite.getRotationCenter()->x;
+            cy = sprite.getRotationCenter()->y;
+        }
+
+        float radians = sprite.getAngle() * M_PI / 180.0f;
+        float c = cos(radians), s = sin(radians);
+        for(float* corner : corners){
+            float dx = corner[0] - cx, dy = corner[1] - cy;
+            corner[0] = cx + dx * c - dy * s;
+            corner[1] = cy + dx * s + dy * c;
+        }
+    }
+
+    int base = vertices.size();
+    for(int i = 0; i < 4; i++){
+        SDL_Vertex vertex;
+        vertex.position = {x + corners[i][0], y + corners[i][1]};
+        vertex.color = {0xFF, 0xFF, 0xFF, 0xFF};
+        vertex.tex_coord = {uvs[i][0], uvs[i][1]};
+        vertices.push_back(vertex);
+    }
+
+    int quad[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+    indices.insert(indices.end(), quad, quad + 6);
+
+    sprite_count++;
+}
+
+void sdl::SpriteBatch::flush(){
+    if(vertices.empty()){
+        return;
+    }
+
+    SDL_RenderGeometry(renderer, texture, vertices.data(), vertices.size(), indices.data(), indices.size());
+
+    draw_calls++;
+    vertex_count += vertices.size();
+
+    vertices.clear();
+    indices.clear();
+}
+
+void sdl::SpriteBatch::end(){
+    flush();
+    texture = nullptr;
+}
+
+int sdl::SpriteBatch::getDrawCalls() const {
+    return draw_calls;
+}
+
+int sdl::SpriteBatch::getVertexCount() const {
+    return vertex_count;
+}
+
+int sdl::SpriteBatch::getSpriteCount() const {
+    return sprite_count;
+}
@@ -0,0 +1,46 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "Sprite.h"
+
+namespace sdl {
+
+// Collects sprites as textured quads and submits each run of the same texture
+// with a single SDL_RenderGeometry call, so draw order is kept
+class SpriteBatch
+{
+    public:
+        SpriteBatch(SDL_Renderer* renderer);
+
+        void begin();
+
+        // texture is what the sprite's handle resolves to, RenderWindow looks it up
+        void draw(sdl::Sprite& sprite, SDL_Texture* texture);
+
+        void flush();
+
+        void end();
+
+        int getDrawCalls() const;
+
+        int getVertexCount() const;
+
+        int getSpriteCount() const;
+
+    private:
+        SDL_Renderer* renderer;
+        SDL_Texture* texture;
+
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
+
+        int draw_calls = 0;
+        int vertex_count = 0;
+        int sprite_count = 0;
+};
+}
+
+#endif // SPRITEBATCH_H
@@ -0,0 +1,71 @@
+#include <SDL2/SDL.h>
+#include <stdexcept>
+#include <vector>
+
+#include "StaticLayer.h"
+
+#include "RenderWindow.h"
+#include "Sprite.h"
+#include "Texture.h"
+#include "TexturePool.h"
+
+sdl::StaticLayer::StaticLayer(sdl::RenderWindow* window)
+: window(window) {
+    texture = window->getTexturePool()->createTarget(window->getWidth(), window->getHeight());
+    if(texture.isNull()){
+        throw std::runtime_error("Failed to create render target");
+    }
+
+    // Drawn 1:1 and fully opaque, blending and filtering would only cost fill rate. The compositor
+    // sees the same from the cleared image being opaque
+    SDL_Texture* target = window->getTexture(texture)->getTexture();
+    if(target != nullptr){
+        SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE);
+        SDL_SetTextureScaleMode(target, SDL_ScaleModeNearest);
+    }
+
+    sprite.setTexture(texture);
+}
+
+sdl::StaticLayer::~StaticLayer(){
+    window->getTexturePool()->destroy(texture);
+}
+
+void sdl::StaticLayer::begin(){
+    window->setTarget(texture);
+    window->clear();
+}
+
+void sdl::StaticLayer::end(){
+    window->setTarget(sdl::TextureHandle());
+    valid = true;
+}
+
+void sdl::StaticLayer::invalidate(){
+    valid = false;
+}
+
+bool sdl::StaticLayer::isValid() const {
+    return valid;
+}
+
+void sdl::StaticLayer::draw(){
+    sprite.setClip(0, 0, texture.width, texture.height);
+    sprite.setPosition(0, 0);
+    sprite.setScale(texture.width, texture.height);
+    window->render(sprite);
+}
+
+void sdl::StaticLayer::restore(const std::vector<SDL_Rect>& rects){
+    // Same texture every time, so the batch folds all of them into one draw
+    for(const SDL_Rect& rect : rects){
+        sprite.setClip(rect.x, rect.y, rect.w, rect.h);
+        sprite.setPosition(rect.x, rect.y);
+        sprite.setScale(rect.w, rect.h);
+        window->render(sprite);
+    }
+}
+
+sdl::TextureHandle sdl::StaticLayer::getTexture() const {
+    return texture;
+}
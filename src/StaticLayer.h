@@ -0,0 +1,48 @@
+#ifndef STATICLAYER_H
+#define STATICLAYER_H
+
+#include <SDL2/SDL.h>
+#include <vector>
+
+#include "RenderWindow.h"
+#include "Sprite.h"
+#include "TexturePool.h"
+
+namespace sdl {
+
+// Window sized render target for everything that only changes with the course.
+// It is composited once, then every frame costs a single opaque blit
+class StaticLayer
+{
+    public:
+        StaticLayer(sdl::RenderWindow* window);
+
+        ~StaticLayer();
+
+        // Everything rendered between begin and end goes into the layer
+        void begin();
+
+        void end();
+
+        // Call when the course changes or the renderer drops its targets
+        void invalidate();
+
+        bool isValid() const;
+
+        void draw();
+
+        // Copies back only the given rects, for backbuffers that keep the previous frame
+        void restore(const std::vector<SDL_Rect>& rects);
+
+        sdl::TextureHandle getTexture() const;
+
+    private:
+        sdl::RenderWindow* window;
+        sdl::TextureHandle texture;
+        sdl::Sprite sprite;
+
+        bool valid = false;
+};
+}
+
+#endif // STATICLAYER_H
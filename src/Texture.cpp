@@ -4,32 +4,84 @@
 
 #include "Texture.h"
 
+#include "Compositor.h"
 #include "Vector2f.h"
 
 sdl::Texture::Texture(SDL_Renderer* renderer) 
-: texture(nullptr), renderer(renderer) {};
+: texture(nullptr), image(nullptr), renderer(renderer) {};
 
 sdl::Texture::~Texture(){
     free();
 }
 
 int sdl::Texture::loadFromFile(const std::string path) {
-    free();
     SDL_Surface* loadedSurface = IMG_Load(path.c_str());
     if(loadedSurface == nullptr){
+        free();
         return 0;
     }
-    
-    //SDL_SetColorKey(loadedSurface, SDL_TRUE, SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
-    
-    texture = SDL_CreateTextureFromSurface(renderer, loadedSurface);
+
+    int loaded = loadFromSurface(loadedSurface);
+    SDL_FreeSurface(loadedSurface);
+
+    return loaded;
+}
+
+int sdl::Texture::loadFromSurface(SDL_Surface* surface) {
+    free();
+
+    //SDL_SetColorKey(surface, SDL_TRUE, SDL_MapRGB(surface->format, 0, 0xFF, 0xFF));
+
+    if(renderer == nullptr){
+        return loadImage(surface);
+    }
+
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
     if(texture == nullptr){
         return 0;
     }
-    size.x = loadedSurface->w;
-    size.y = loadedSurface->h;
-    SDL_FreeSurface(loadedSurface);
-    
+    size.x = surface->w;
+    size.y = surface->h;
+
+    return 1;
+}
+
+int sdl::Texture::createTarget(int width, int height) {
+    free();
+
+    if(renderer == nullptr){
+        image = new sdl::Image(width, height);
+        size.x = width;
+        size.y = height;
+        return 1;
+    }
+
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if(texture == nullptr){
+        return 0;
+    }
+    size.x = width;
+    size.y = height;
+
+    return 1;
+}
+
+int sdl::Texture::loadImage(SDL_Surface* surface) {
+    // ARGB8888 is the Image layout, straight alpha until Image::load premultiplies it
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if(converted == nullptr){
+        return 0;
+    }
+
+    SDL_LockSurface(converted);
+    image = new sdl::Image();
+    image->load((const uint32_t*)converted->pixels, converted->w, converted->h, converted->pitch / 4);
+    SDL_UnlockSurface(converted);
+    SDL_FreeSurface(converted);
+
+    size.x = image->getWidth();
+    size.y = image->getHeight();
+
     return 1;
 }
 
@@ -39,12 +91,22 @@ void sdl::Texture::free(){
         texture = nullptr;
         size = math::Vector2f();
     }
+
+    if(image != nullptr){
+        delete image;
+        image = nullptr;
+        size = math::Vector2f();
+    }
 }
 
 SDL_Texture* sdl::Texture::getTexture() const {
     return texture;
 }
 
+sdl::Image* sdl::Texture::getImage() const {
+    return image;
+}
+
 float sdl::Texture::getWidth() const {
     return size.x;
 }
@@ -5,22 +5,37 @@
 #include <SDL2/SDL_image.h>
 #include <string>
 
+#include "Compositor.h"
 #include "Vector2f.h"
 
 namespace sdl {
 
+// Without a renderer the pixels are kept as a premultiplied sdl::Image for the Compositor instead
 class Texture {
     public:
         Texture(SDL_Renderer* renderer);
 
         ~Texture();
 
+        // Owns the SDL texture, a copy would free it twice
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
         int loadFromFile(const std::string path);
 
+        // Uploads an already decoded surface, the surface stays owned by the caller
+        int loadFromSurface(SDL_Surface* surface);
+
+        // Blank texture that can be rendered into with RenderWindow::setTarget
+        int createTarget(int width, int height);
+
         void free();
 
         SDL_Texture* getTexture() const;
 
+        // Only set for textures without a renderer
+        sdl::Image* getImage() const;
+
         float getWidth() const;
 
         float getHeight() const;
@@ -28,7 +43,10 @@ class Texture {
         math::Vector2f& getSize();
 
     private:
+        int loadImage(SDL_Surface* surface);
+
         SDL_Texture* texture;
+        sdl::Image* image;
         SDL_Renderer* renderer;
         math::Vector2f size;
 
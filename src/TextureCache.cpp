@@ -0,0 +1,75 @@
+#include <SDL2/SDL.h>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "TextureCache.h"
+
+#include "TexturePool.h"
+
+sdl::TextureCache::TextureCache(sdl::TexturePool& pool)
+: pool(pool) {}
+
+sdl::TextureCache::~TextureCache(){
+    clear();
+}
+
+sdl::TextureHandle sdl::TextureCache::acquire(const std::string& path){
+    auto it = entries.find(path);
+    if(it != entries.end()){
+        it->second.references++;
+        return it->second.texture;
+    }
+
+    sdl::TextureHandle texture = pool.loadFromFile(path);
+    if(texture.isNull()){
+        throw std::runtime_error("Failed to load texture from file");
+    }
+
+    entries[path] = {texture, 1};
+    return texture;
+}
+
+sdl::TextureHandle sdl::TextureCache::acquire(const std::string& path, SDL_Surface* surface){
+    auto it = entries.find(path);
+    if(it != entries.end()){
+        it->second.references++;
+        return it->second.texture;
+    }
+
+    sdl::TextureHandle texture = pool.loadFromSurface(surface);
+    if(texture.isNull()){
+        throw std::runtime_error("Failed to create texture from surface");
+    }
+
+    entries[path] = {texture, 1};
+    return texture;
+}
+
+void sdl::TextureCache::release(sdl::TextureHandle texture){
+    for(auto it = entries.begin(); it != entries.end(); it++){
+        if(it->second.texture == texture){
+            if(--it->second.references == 0){
+                pool.destroy(it->second.texture);
+                entries.erase(it);
+            }
+            return;
+        }
+    }
+}
+
+int sdl::TextureCache::getReferences(const std::string path) const {
+    auto it = entries.find(path);
+    return it != entries.end() ? it->second.references : 0;
+}
+
+size_t sdl::TextureCache::size() const {
+    return entries.size();
+}
+
+void sdl::TextureCache::clear(){
+    for(auto& entry : entries){
+        pool.destroy(entry.second.texture);
+    }
+    entries.clear();
+}
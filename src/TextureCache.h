@@ -0,0 +1,44 @@
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <SDL2/SDL.h>
+#include <string>
+#include <unordered_map>
+
+#include "TexturePool.h"
+
+namespace sdl {
+
+// Path keyed textures, a path is decoded and uploaded once and freed when its last user releases it
+class TextureCache
+{
+    public:
+        TextureCache(sdl::TexturePool& pool);
+
+        ~TextureCache();
+
+        sdl::TextureHandle acquire(const std::string& path);
+
+        // Same as above but uploads a surface decoded elsewhere when the path is not cached yet
+        sdl::TextureHandle acquire(const std::string& path, SDL_Surface* surface);
+
+        void release(sdl::TextureHandle texture);
+
+        int getReferences(const std::string path) const;
+
+        size_t size() const;
+
+        void clear();
+
+    private:
+        struct Entry {
+            sdl::TextureHandle texture;
+            int references;
+        };
+
+        sdl::TexturePool& pool;
+        std::unordered_map<std::string, Entry> entries;
+};
+}
+
+#endif // TEXTURECACHE_H
@@ -0,0 +1,113 @@
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TexturePool.h"
+
+#include "Texture.h"
+
+sdl::TexturePool::TexturePool(SDL_Renderer* renderer)
+: renderer(renderer) {}
+
+sdl::TexturePool::~TexturePool(){
+    clear();
+}
+
+sdl::TextureHandle sdl::TexturePool::loadFromFile(const std::string path){
+    uint16_t index = allocate();
+    if(!slots[index].texture.loadFromFile(path)){
+        free_slots.push_back(index);
+        return TextureHandle();
+    }
+    return publish(index);
+}
+
+sdl::TextureHandle sdl::TexturePool::loadFromSurface(SDL_Surface* surface){
+    uint16_t index = allocate();
+    if(!slots[index].texture.loadFromSurface(surface)){
+        free_slots.push_back(index);
+        return TextureHandle();
+    }
+    return publish(index);
+}
+
+sdl::TextureHandle sdl::TexturePool::createTarget(int width, int height){
+    uint16_t index = allocate();
+    if(!slots[index].texture.createTarget(width, height)){
+        free_slots.push_back(index);
+        return TextureHandle();
+    }
+    return publish(index);
+}
+
+void sdl::TexturePool::destroy(TextureHandle handle){
+    if(!isValid(handle)){
+        return;
+    }
+
+    Slot& slot = slots[handle.index];
+    slot.texture.free();
+    slot.live = false;
+
+    // 0 marks the null handle, skip it on wrap around
+    if(++slot.generation == 0){
+        slot.generation = 1;
+    }
+
+    free_slots.push_back(handle.index);
+    live--;
+}
+
+sdl::Texture* sdl::TexturePool::get(TextureHandle handle){
+    return isValid(handle) ? &slots[handle.index].texture : nullptr;
+}
+
+bool sdl::TexturePool::isValid(TextureHandle handle) const {
+    return handle.index < slots.size() && slots[handle.index].live && slots[handle.index].generation == handle.generation;
+}
+
+size_t sdl::TexturePool::size() const {
+    return live;
+}
+
+void sdl::TexturePool::clear(){
+    for(uint16_t i = 0; i < slots.size(); i++){
+        if(slots[i].live){
+            TextureHandle handle;
+            handle.index = i;
+            handle.generation = slots[i].generation;
+            destroy(handle);
+        }
+    }
+}
+
+uint16_t sdl::TexturePool::allocate(){
+    if(!free_slots.empty()){
+        uint16_t index = free_slots.back();
+        free_slots.pop_back();
+        return index;
+    }
+
+    if(slots.size() > UINT16_MAX){
+        throw std::runtime_error("Texture pool is full");
+    }
+
+    slots.emplace_back(renderer);
+    return slots.size() - 1;
+}
+
+sdl::TextureHandle sdl::TexturePool::publish(uint16_t index){
+    Slot& slot = slots[index];
+    slot.live = true;
+    live++;
+
+    TextureHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    handle.width = slot.texture.getWidth();
+    handle.height = slot.texture.getHeight();
+    return handle;
+}
@@ -0,0 +1,86 @@
+#ifndef TEXTUREPOOL_H
+#define TEXTUREPOOL_H
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+
+namespace sdl {
+
+// Reference to a pool slot, it goes stale once the texture is destroyed and the slot is reused.
+// The size rides along so sprites can lay themselves out without reaching the pool
+struct TextureHandle {
+    uint16_t index = 0;
+    uint16_t generation = 0;    // never 0 for a live texture, so a default handle is null
+    uint16_t width = 0;
+    uint16_t height = 0;
+
+    bool isNull() const {
+        return generation == 0;
+    }
+
+    bool operator==(const TextureHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const TextureHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+// Owns every texture of a renderer in slots that are reused, freed slots bump their generation
+class TexturePool
+{
+    public:
+        TexturePool(SDL_Renderer* renderer);
+
+        ~TexturePool();
+
+        // Null handle on failure
+        TextureHandle loadFromFile(const std::string path);
+
+        // The surface stays owned by the caller
+        TextureHandle loadFromSurface(SDL_Surface* surface);
+
+        TextureHandle createTarget(int width, int height);
+
+        // Frees the texture, the handle and every copy of it go stale
+        void destroy(TextureHandle handle);
+
+        // nullptr for null and stale handles
+        sdl::Texture* get(TextureHandle handle);
+
+        bool isValid(TextureHandle handle) const;
+
+        // Live textures
+        size_t size() const;
+
+        void clear();
+
+    private:
+        struct Slot {
+            Slot(SDL_Renderer* renderer) : texture(renderer) {}
+
+            sdl::Texture texture;
+            uint16_t generation = 1;
+            bool live = false;
+        };
+
+        uint16_t allocate();
+
+        TextureHandle publish(uint16_t index);
+
+        SDL_Renderer* renderer;
+
+        // Slots never move once created, so growing the pool keeps every texture where it is
+        std::deque<Slot> slots;
+        std::vector<uint16_t> free_slots;
+        size_t live = 0;
+};
+}
+
+#endif // TEXTUREPOOL_H
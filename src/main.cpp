@@ -1,8 +1,125 @@
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include "App.h"
 
+// Whole string a finite number, no trailing junk like atof lets through
+bool parseNumber(const char* text, double& value){
+    char* end = nullptr;
+    value = strtod(text, &end);
+    return end != text && *end == '\0' && std::isfinite(value);
+}
+
+bool parseCount(const char* text, int& value){
+    char* end = nullptr;
+    errno = 0;
+    long parsed = strtol(text, &end, 10);
+    if(end == text || *end != '\0' || errno != 0 || parsed < 0 || parsed > INT_MAX){
+        return false;
+    }
+    value = (int)parsed;
+    return true;
+}
+
+int usage(const char* name){
+    fprintf(stderr, "usage: %s [--tick-rate <hz>] [--record <file>] [--balls <count>] [--headless] [--capture <path>]"
+                    " [--frames <count>] [--dirty-regions] [--overlay-font <ttf>] [course files...]\n", name);
+    return 1;
+}
+
+// usage: main [--tick-rate <hz>] [--record <file>] [--balls <count>] [--headless] [--capture <path>] [--frames <count>]
+//             [--dirty-regions] [--overlay-font <ttf>] [course files...]
+// Optional course files to play in order, otherwise every hole is randomized.
+// --headless renders offscreen, --capture writes its frames to numbered PNGs like frame%04d.png or a .raw stream
+// (- for stdout), --frames quits after that many frames. --dirty-regions redraws only what moved on the software renderer,
+// which works as long as it keeps the last frame, something SDL does not guarantee. --overlay-font is the font of the
+// profiler overlay in profiling builds. An unknown option or a bad value prints the usage and exits with 1
 int main(int argc, char* args[]){
-    App app;
-    app.run();
+    std::vector<std::string> courses;
+    double tick_rate = 62.5;
+    std::string record;
+    int balls = 0;
+    bool headless = false;
+    std::string capture;
+    int frames = 0;
+    bool dirty_regions = false;
+    std::string overlay_font;
+
+    for(int i = 1; i < argc; i++){
+        // Every option but the two flags takes a value
+        bool flag = strcmp(args[i], "--dirty-regions") == 0 || strcmp(args[i], "--headless") == 0;
+        if(strncmp(args[i], "--", 2) == 0 && !flag && i + 1 >= argc){
+            return usage(args[0]);
+        }
+
+        if(strcmp(args[i], "--tick-rate") == 0){
+            if(!parseNumber(args[++i], tick_rate) || tick_rate <= 0){
+                return usage(args[0]);
+            }
+        }
+        else if(strcmp(args[i], "--record") == 0){
+            record = args[++i];
+        }
+        else if(strcmp(args[i], "--balls") == 0){
+            if(!parseCount(args[++i], balls)){
+                return usage(args[0]);
+            }
+        }
+        else if(strcmp(args[i], "--overlay-font") == 0){
+            overlay_font = args[++i];
+        }
+        else if(strcmp(args[i], "--dirty-regions") == 0){
+            dirty_regions = true;
+        }
+        else if(strcmp(args[i], "--headless") == 0){
+            headless = true;
+        }
+        else if(strcmp(args[i], "--capture") == 0){
+            capture = args[++i];
+        }
+        else if(strcmp(args[i], "--frames") == 0){
+            if(!parseCount(args[++i], frames)){
+                return usage(args[0]);
+            }
+        }
+        else if(strncmp(args[i], "--", 2) == 0){
+            return usage(args[0]);
+        }
+        else {
+            courses.push_back(args[i]);
+        }
+    }
+
+    // Assets and course files load inside run(), a missing one ends the game here rather than with an abort
+    try {
+        App app(courses, tick_rate, balls, headless);
+        if(!record.empty()){
+            app.record(record);
+        }
+        if(!capture.empty() && !app.capture(capture)){
+            fprintf(stderr, "Failed to capture to %s, it needs --headless and a .raw file, - or a name with one %%d\n", capture.c_str());
+            return 1;
+        }
+        if(!overlay_font.empty()){
+            app.setOverlayFont(overlay_font);
+        }
+        if(dirty_regions){
+            app.setDirtyRegions(true);
+        }
+        app.setFrameLimit(frames);
+        app.run();
+    }
+    catch(const std::runtime_error& e){
+        fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,79 @@
+#include <cmath>
+
+#include "Ball.h"
+
+#include "../Vector2f.h"
+
+sim::Ball::Ball() : Body(), velocity(0.0f, 0.0f), moving(false) {};
+
+sim::Ball::Ball(math::Vector2f position, math::Vector2f scale)
+: Body(position, scale), velocity(0.0f, 0.0f), moving(false) {};
+
+void sim::Ball::update(float dt){
+
+    if(moving){
+        //velocity1D = (velocity / 10).magnitude();
+        // float pow on purpose, BallBatch reproduces this bit for bit
+        float decay = std::pow(friction, dt) * ((velocity1D < 10.0f) ? slowDecay(dt) : 1.0f);
+        velocity.x *= decay;
+        velocity.y *= decay;
+        velocity1D = (velocity / 10).magnitude();
+
+        setPosition(getPosition() + velocity * dt);
+
+        if(velocity.x < 0.5f && velocity.x > -0.5f){
+            velocity.x = 0.0f;
+        }
+
+        if(velocity.y < 0.5f && velocity.y > -0.5f){
+            velocity.y = 0.0f;
+        }
+
+        if(velocity.x == 0.0f && velocity.y == 0.0f){
+            moving = false;
+        }
+    }
+}
+
+float sim::Ball::slowDecay(float dt){
+    // Exact at the reference tick so stepped results do not move
+    return dt == reference_dt ? slow_friction : std::pow(slow_friction, dt / reference_dt);
+}
+
+void sim::Ball::shrink(float shrink_factor){
+    setScale(getScale().x - shrink_factor, getScale().y - shrink_factor);
+    setPosition(getPosition().x + shrink_factor / 2.0f, getPosition().y + shrink_factor / 2.0f);
+}
+
+void sim::Ball::setVelocity(math::Vector2f velocity){
+    this->velocity = velocity;
+}
+
+void sim::Ball::setVelocity(float x, float y){
+    this->velocity.x = x;
+    this->velocity.y = y;
+}
+
+void sim::Ball::setVelocity1D(float velocity){
+    this->velocity1D = velocity;
+}
+
+float sim::Ball::getVelocity1D() const {
+    return velocity1D;
+}
+
+void sim::Ball::setMoving(bool moving){
+    this->moving = moving;
+}
+
+bool sim::Ball::isMoving() const {
+    return moving;
+}
+
+math::Vector2f& sim::Ball::getVelocity(){
+    return velocity;
+}
+
+const math::Vector2f& sim::Ball::getVelocity() const {
+    return velocity;
+}
@@ -0,0 +1,49 @@
+#ifndef SIM_BALL_H
+#define SIM_BALL_H
+
+#include "Body.h"
+
+namespace sim {
+
+class Ball : public Body
+{
+    public:
+        Ball();
+
+        Ball(math::Vector2f position, math::Vector2f scale);
+
+        void update(float dt);
+
+        void shrink(float shrink_factor);
+
+        void setVelocity(math::Vector2f velocity);
+
+        void setVelocity(float x, float y);
+
+        void setVelocity1D(float velocity);
+
+        float getVelocity1D() const;
+
+        void setMoving(bool moving);
+
+        bool isMoving() const;
+
+        math::Vector2f& getVelocity();
+
+        const math::Vector2f& getVelocity() const;
+
+        // Extra damping below velocity1D 10, tuned as a per tick factor at reference_dt and scaled for other tick lengths
+        static float slowDecay(float dt);
+
+        static constexpr float friction = 0.6f;
+        static constexpr float slow_friction = 0.99f;
+        static constexpr float reference_dt = 0.016f;
+
+    private:
+        math::Vector2f velocity;
+        float velocity1D = 0.0f;
+        bool moving = false;
+};
+}
+
+#endif // SIM_BALL_H
@@ -0,0 +1,300 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIM_BATCH_X86
+#endif
+
+#include "BallBatch.h"
+
+#include "../Vector2f.h"
+#include "Ball.h"
+
+namespace {
+
+sim::BatchKernel active_kernel = sim::BallBatch::detectKernel();
+
+}
+
+sim::BallBatch::BallBatch() {}
+
+size_t sim::BallBatch::add(const Ball& ball){
+    if(count % LANES == 0){
+        size_t padded = count + LANES;
+        x.resize(padded, 0.0f);
+        y.resize(padded, 0.0f);
+        vx.resize(padded, 0.0f);
+        vy.resize(padded, 0.0f);
+        speed.resize(padded, 0.0f);
+        moving.resize(padded, 0);
+    }
+
+    load(count, ball);
+
+    return count++;
+}
+
+void sim::BallBatch::load(size_t index, const Ball& ball){
+    x[index] = ball.getPosition().x;
+    y[index] = ball.getPosition().y;
+    vx[index] = ball.getVelocity().x;
+    vy[index] = ball.getVelocity().y;
+    speed[index] = ball.getVelocity1D();
+    moving[index] = ball.isMoving() ? UINT32_MAX : 0;
+}
+
+void sim::BallBatch::store(size_t index, Ball& ball) const {
+    ball.setPosition(x[index], y[index]);
+    ball.setVelocity(vx[index], vy[index]);
+    ball.setVelocity1D(speed[index]);
+    ball.setMoving(moving[index] != 0);
+}
+
+void sim::BallBatch::erase(size_t index){
+    for(std::vector<float>* lanes : {&x, &y, &vx, &vy, &speed}){
+        lanes->erase(lanes->begin() + index);
+        lanes->push_back(0.0f);
+    }
+    moving.erase(moving.begin() + index);
+    moving.push_back(0);
+
+    count--;
+}
+
+void sim::BallBatch::clear(){
+    x.clear();
+    y.clear();
+    vx.clear();
+    vy.clear();
+    speed.clear();
+    moving.clear();
+    count = 0;
+}
+
+void sim::BallBatch::update(float dt){
+    update(dt, active_kernel);
+}
+
+void sim::BallBatch::update(float dt, BatchKernel kernel){
+    switch(kernel){
+        case BatchKernel::AVX2:
+            updateAVX2(dt);
+            break;
+        case BatchKernel::SSE2:
+            updateSSE2(dt);
+            break;
+        default:
+            updateScalar(dt);
+            break;
+    }
+}
+
+size_t sim::BallBatch::size() const {
+    return count;
+}
+
+bool sim::BallBatch::isMoving(size_t index) const {
+    return moving[index] != 0;
+}
+
+size_t sim::BallBatch::countMoving() const {
+    size_t n = 0;
+    for(size_t i = 0; i < count; i++){
+        n += moving[i] != 0;
+    }
+    return n;
+}
+
+sim::BatchKernel sim::BallBatch::detectKernel(){
+#ifdef SIM_BATCH_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")){
+        return BatchKernel::AVX2;
+    }
+    if(__builtin_cpu_supports("sse2")){
+        return BatchKernel::SSE2;
+    }
+#endif
+    return BatchKernel::SCALAR;
+}
+
+void sim::BallBatch::setKernel(BatchKernel kernel){
+    active_kernel = kernel;
+}
+
+sim::BatchKernel sim::BallBatch::getKernel(){
+    return active_kernel;
+}
+
+const char* sim::BallBatch::kernelName(BatchKernel kernel){
+    switch(kernel){
+        case BatchKernel::AVX2:
+            return "avx2";
+        case BatchKernel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+// Same operations in the same order as Ball::update, one lane at a time
+void sim::BallBatch::updateScalar(float dt){
+    float decay = std::pow(Ball::friction, dt);
+    float slow_decay = decay * Ball::slowDecay(dt);
+
+    for(size_t i = 0; i < count; i++){
+        if(!moving[i]){
+            continue;
+        }
+
+        float d = (speed[i] < 10.0f) ? slow_decay : decay;
+        vx[i] *= d;
+        vy[i] *= d;
+
+        float sx = vx[i] / 10;
+        float sy = vy[i] / 10;
+        speed[i] = std::sqrt(sx * sx + sy * sy);
+
+        x[i] = x[i] + vx[i] * dt;
+        y[i] = y[i] + vy[i] * dt;
+
+        if(vx[i] < 0.5f && vx[i] > -0.5f){
+            vx[i] = 0.0f;
+        }
+
+        if(vy[i] < 0.5f && vy[i] > -0.5f){
+            vy[i] = 0.0f;
+        }
+
+        if(vx[i] == 0.0f && vy[i] == 0.0f){
+            moving[i] = 0;
+        }
+    }
+}
+
+#ifdef SIM_BATCH_X86
+
+// Mul and add are kept separate (no fma) so rounding matches the scalar path
+void sim::BallBatch::updateSSE2(float dt){
+    float decay = std::pow(Ball::friction, dt);
+    float slow_decay = decay * Ball::slowDecay(dt);
+
+    const __m128 v_decay = _mm_set1_ps(decay);
+    const __m128 v_slow_decay = _mm_set1_ps(slow_decay);
+    const __m128 v_dt = _mm_set1_ps(dt);
+    const __m128 v_ten = _mm_set1_ps(10.0f);
+    const __m128 v_half = _mm_set1_ps(0.5f);
+    const __m128 v_neg_half = _mm_set1_ps(-0.5f);
+    const __m128 v_zero = _mm_setzero_ps();
+
+    for(size_t i = 0; i < count; i += 4){
+        __m128 m = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&moving[i]));
+        if(_mm_movemask_ps(m) == 0){
+            continue;
+        }
+
+        __m128 px = _mm_loadu_ps(&x[i]);
+        __m128 py = _mm_loadu_ps(&y[i]);
+        __m128 pvx = _mm_loadu_ps(&vx[i]);
+        __m128 pvy = _mm_loadu_ps(&vy[i]);
+        __m128 ps = _mm_loadu_ps(&speed[i]);
+
+        __m128 slow = _mm_cmplt_ps(ps, v_ten);
+        __m128 d = _mm_or_ps(_mm_and_ps(slow, v_slow_decay), _mm_andnot_ps(slow, v_decay));
+
+        __m128 nvx = _mm_mul_ps(pvx, d);
+        __m128 nvy = _mm_mul_ps(pvy, d);
+
+        __m128 sx = _mm_div_ps(nvx, v_ten);
+        __m128 sy = _mm_div_ps(nvy, v_ten);
+        __m128 ns = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(sx, sx), _mm_mul_ps(sy, sy)));
+
+        __m128 npx = _mm_add_ps(px, _mm_mul_ps(nvx, v_dt));
+        __m128 npy = _mm_add_ps(py, _mm_mul_ps(nvy, v_dt));
+
+        __m128 dead_x = _mm_and_ps(_mm_cmplt_ps(nvx, v_half), _mm_cmpgt_ps(nvx, v_neg_half));
+        __m128 dead_y = _mm_and_ps(_mm_cmplt_ps(nvy, v_half), _mm_cmpgt_ps(nvy, v_neg_half));
+        nvx = _mm_andnot_ps(dead_x, nvx);
+        nvy = _mm_andnot_ps(dead_y, nvy);
+
+        __m128 stopped = _mm_and_ps(_mm_cmpeq_ps(nvx, v_zero), _mm_cmpeq_ps(nvy, v_zero));
+        __m128 nm = _mm_andnot_ps(stopped, m);
+
+        _mm_storeu_ps(&x[i], _mm_or_ps(_mm_and_ps(m, npx), _mm_andnot_ps(m, px)));
+        _mm_storeu_ps(&y[i], _mm_or_ps(_mm_and_ps(m, npy), _mm_andnot_ps(m, py)));
+        _mm_storeu_ps(&vx[i], _mm_or_ps(_mm_and_ps(m, nvx), _mm_andnot_ps(m, pvx)));
+        _mm_storeu_ps(&vy[i], _mm_or_ps(_mm_and_ps(m, nvy), _mm_andnot_ps(m, pvy)));
+        _mm_storeu_ps(&speed[i], _mm_or_ps(_mm_and_ps(m, ns), _mm_andnot_ps(m, ps)));
+        _mm_storeu_si128((__m128i*)&moving[i], _mm_castps_si128(nm));
+    }
+}
+
+__attribute__((target("avx2")))
+void sim::BallBatch::updateAVX2(float dt){
+    float decay = std::pow(Ball::friction, dt);
+    float slow_decay = decay * Ball::slowDecay(dt);
+
+    const __m256 v_decay = _mm256_set1_ps(decay);
+    const __m256 v_slow_decay = _mm256_set1_ps(slow_decay);
+    const __m256 v_dt = _mm256_set1_ps(dt);
+    const __m256 v_ten = _mm256_set1_ps(10.0f);
+    const __m256 v_half = _mm256_set1_ps(0.5f);
+    const __m256 v_neg_half = _mm256_set1_ps(-0.5f);
+    const __m256 v_zero = _mm256_setzero_ps();
+
+    for(size_t i = 0; i < count; i += 8){
+        __m256 m = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&moving[i]));
+        if(_mm256_movemask_ps(m) == 0){
+            continue;
+        }
+
+        __m256 px = _mm256_loadu_ps(&x[i]);
+        __m256 py = _mm256_loadu_ps(&y[i]);
+        __m256 pvx = _mm256_loadu_ps(&vx[i]);
+        __m256 pvy = _mm256_loadu_ps(&vy[i]);
+        __m256 ps = _mm256_loadu_ps(&speed[i]);
+
+        __m256 slow = _mm256_cmp_ps(ps, v_ten, _CMP_LT_OQ);
+        __m256 d = _mm256_blendv_ps(v_decay, v_slow_decay, slow);
+
+        __m256 nvx = _mm256_mul_ps(pvx, d);
+        __m256 nvy = _mm256_mul_ps(pvy, d);
+
+        __m256 sx = _mm256_div_ps(nvx, v_ten);
+        __m256 sy = _mm256_div_ps(nvy, v_ten);
+        __m256 ns = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(sx, sx), _mm256_mul_ps(sy, sy)));
+
+        __m256 npx = _mm256_add_ps(px, _mm256_mul_ps(nvx, v_dt));
+        __m256 npy = _mm256_add_ps(py, _mm256_mul_ps(nvy, v_dt));
+
+        __m256 dead_x = _mm256_and_ps(_mm256_cmp_ps(nvx, v_half, _CMP_LT_OQ), _mm256_cmp_ps(nvx, v_neg_half, _CMP_GT_OQ));
+        __m256 dead_y = _mm256_and_ps(_mm256_cmp_ps(nvy, v_half, _CMP_LT_OQ), _mm256_cmp_ps(nvy, v_neg_half, _CMP_GT_OQ));
+        nvx = _mm256_andnot_ps(dead_x, nvx);
+        nvy = _mm256_andnot_ps(dead_y, nvy);
+
+        __m256 stopped = _mm256_and_ps(_mm256_cmp_ps(nvx, v_zero, _CMP_EQ_OQ), _mm256_cmp_ps(nvy, v_zero, _CMP_EQ_OQ));
+        __m256 nm = _mm256_andnot_ps(stopped, m);
+
+        _mm256_storeu_ps(&x[i], _mm256_blendv_ps(px, npx, m));
+        _mm256_storeu_ps(&y[i], _mm256_blendv_ps(py, npy, m));
+        _mm256_storeu_ps(&vx[i], _mm256_blendv_ps(pvx, nvx, m));
+        _mm256_storeu_ps(&vy[i], _mm256_blendv_ps(pvy, nvy, m));
+        _mm256_storeu_ps(&speed[i], _mm256_blendv_ps(ps, ns, m));
+        _mm256_storeu_si256((__m256i*)&moving[i], _mm256_castps_si256(nm));
+    }
+}
+
+#else
+
+void sim::BallBatch::updateSSE2(float dt){
+    updateScalar(dt);
+}
+
+void sim::BallBatch::updateAVX2(float dt){
+    updateScalar(dt);
+}
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef SIM_BALLBATCH_H
+#define SIM_BALLBATCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Ball.h"
+
+namespace sim {
+
+enum BatchKernel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Structure of arrays copy of many balls, update() runs the Ball::update integration
+// over every lane at once and gives bit identical results to the scalar path
+class BallBatch
+{
+    public:
+        BallBatch();
+
+        size_t add(const Ball& ball);
+
+        void load(size_t index, const Ball& ball);
+
+        void store(size_t index, Ball& ball) const;
+
+        // Shifts every lane after index down by one
+        void erase(size_t index);
+
+        void clear();
+
+        void update(float dt);
+
+        void update(float dt, BatchKernel kernel);
+
+        size_t size() const;
+
+        bool isMoving(size_t index) const;
+
+        size_t countMoving() const;
+
+        // Best kernel the running cpu supports, picked once
+        static BatchKernel detectKernel();
+
+        static void setKernel(BatchKernel kernel);
+
+        static BatchKernel getKernel();
+
+        static const char* kernelName(BatchKernel kernel);
+
+        // Lanes are padded up to this so the vector kernels never need a tail loop
+        static constexpr size_t LANES = 8;
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> vx;
+        std::vector<float> vy;
+        std::vector<float> speed;
+        std::vector<uint32_t> moving;   // all bits set while moving, zero otherwise
+
+    private:
+        void updateScalar(float dt);
+        void updateSSE2(float dt);
+        void updateAVX2(float dt);
+
+        size_t count = 0;
+};
+}
+
+#endif // SIM_BALLBATCH_H
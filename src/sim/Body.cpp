@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Body.h"
+
+#include "../Vector2f.h"
+
+sim::Body::Body()
+: position(0, 0), scale(0, 0) {}
+
+sim::Body::Body(math::Vector2f position, math::Vector2f scale)
+: position(position), scale(scale) {}
+
+sim::Direction sim::Body::collidesWith(const Body& other) const {
+    if(position.x >= other.position.x + other.scale.x ||
+       position.x + scale.x <= other.position.x ||
+       position.y >= other.position.y + other.scale.y ||
+       position.y + scale.y <= other.position.y){
+          return sim::Direction::NONE;
+    }
+    else {
+        math::Vector2f distance = getCenter() - other.getCenter();
+
+        if(std::abs(distance.x) > std::abs(distance.y)){
+            if(distance.x > 0){
+                return sim::Direction::RIGHT;
+            }
+            else {
+                return sim::Direction::LEFT;
+            }
+        }
+        else {
+            if(distance.y > 0){
+                return sim::Direction::DOWN;
+            }
+            else {
+                return sim::Direction::UP;
+            }
+        }
+    }
+}
+
+bool sim::Body::sweep(const Body& other, math::Vector2f displacement, float& time, Direction& face) const {
+    // Quick reject when the box covered by the whole move never reaches other
+    if(position.x + std::min(0.0f, displacement.x) >= other.position.x + other.scale.x ||
+       position.x + std::max(0.0f, displacement.x) + scale.x <= other.position.x ||
+       position.y + std::min(0.0f, displacement.y) >= other.position.y + other.scale.y ||
+       position.y + std::max(0.0f, displacement.y) + scale.y <= other.position.y){
+        return false;
+    }
+
+    Direction overlap = collidesWith(other);
+    if(overlap != sim::Direction::NONE){
+        time = 0.0f;
+        face = overlap;
+        return true;
+    }
+
+    // Ray from position against other grown by our size, open intervals like collidesWith
+    float lo_x = other.position.x - scale.x, hi_x = other.position.x + other.scale.x;
+    float lo_y = other.position.y - scale.y, hi_y = other.position.y + other.scale.y;
+
+    float enter_x, exit_x, enter_y, exit_y;
+    if(displacement.x == 0.0f){
+        if(position.x <= lo_x || position.x >= hi_x){
+            return false;
+        }
+        enter_x = -INFINITY;
+        exit_x = INFINITY;
+    }
+    else {
+        float a = (lo_x - position.x) / displacement.x;
+        float b = (hi_x - position.x) / displacement.x;
+        enter_x = std::min(a, b);
+        exit_x = std::max(a, b);
+    }
+
+    if(displacement.y == 0.0f){
+        if(position.y <= lo_y || position.y >= hi_y){
+            return false;
+        }
+        enter_y = -INFINITY;
+        exit_y = INFINITY;
+    }
+    else {
+        float a = (lo_y - position.y) / displacement.y;
+        float b = (hi_y - position.y) / displacement.y;
+        enter_y = std::min(a, b);
+        exit_y = std::max(a, b);
+    }
+
+    float enter = std::max(enter_x, enter_y);
+    float exit = std::min(exit_x, exit_y);
+    if(enter >= exit || enter < 0.0f || enter >= 1.0f){
+        return false;
+    }
+
+    time = enter;
+    if(enter_x > enter_y){
+        face = displacement.x > 0.0f ? sim::Direction::LEFT : sim::Direction::RIGHT;
+    }
+    else {
+        face = displacement.y > 0.0f ? sim::Direction::UP : sim::Direction::DOWN;
+    }
+
+    return true;
+}
+
+void sim::Body::setScale(math::Vector2f scale){
+    this->scale = scale;
+}
+
+void sim::Body::setScale(float x, float y){
+    this->scale.x = x;
+    this->scale.y = y;
+}
+
+void sim::Body::setPosition(math::Vector2f position){
+    this->position = position;
+}
+
+void sim::Body::setPosition(float x, float y){
+    this->position.x = x;
+    this->position.y = y;
+}
+
+math::Vector2f& sim::Body::getScale(){
+    return scale;
+}
+
+const math::Vector2f& sim::Body::getScale() const {
+    return scale;
+}
+
+math::Vector2f& sim::Body::getPosition(){
+    return position;
+}
+
+const math::Vector2f& sim::Body::getPosition() const {
+    return position;
+}
+
+math::Vector2f sim::Body::getCenter() const {
+    return math::Vector2f(position.x + (scale.x / 2), position.y + (scale.y / 2));
+}
@@ -0,0 +1,54 @@
+#ifndef SIM_BODY_H
+#define SIM_BODY_H
+
+#include "../Vector2f.h"
+
+namespace sim {
+
+enum Direction {
+    NONE = -1,
+    UP = 0,
+    DOWN = 1,
+    LEFT = 2,
+    RIGHT = 3
+};
+
+// Axis aligned box used by the simulation, mirrors the geometry half of sdl::Sprite
+class Body
+{
+    public:
+        Body();
+
+        Body(math::Vector2f position, math::Vector2f scale);
+
+        Direction collidesWith(const Body& other) const;
+
+        // Time of impact in [0, 1) moving by displacement, face is the side of other that gets hit
+        // as collidesWith would name it, already overlapping bodies report time 0
+        bool sweep(const Body& other, math::Vector2f displacement, float& time, Direction& face) const;
+
+        void setScale(math::Vector2f scale);
+
+        void setScale(float x, float y);
+
+        void setPosition(math::Vector2f position);
+
+        void setPosition(float x, float y);
+
+        math::Vector2f& getScale();
+
+        const math::Vector2f& getScale() const;
+
+        math::Vector2f& getPosition();
+
+        const math::Vector2f& getPosition() const;
+
+        math::Vector2f getCenter() const;
+
+    protected:
+        math::Vector2f position;
+        math::Vector2f scale;
+};
+}
+
+#endif // SIM_BODY_H
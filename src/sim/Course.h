@@ -0,0 +1,43 @@
+#ifndef SIM_COURSE_H
+#define SIM_COURSE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "Tile.h"
+
+namespace sim {
+
+enum TextureSlot {
+    BALL_TEXTURE,
+    HOLE_TEXTURE,
+    TILE_TEXTURE,
+    FIELD_TEXTURE,
+    TEXTURE_SLOTS
+};
+
+// Optional image override for one slot, fixed size so course files can store it as is
+struct TextureRef {
+    uint32_t slot;
+    char path[60];
+};
+
+// Everything needed to rebuild a World at the start of a hole
+struct Course {
+    int width = 0;
+    int height = 0;
+
+    math::Vector2f ball_position;
+    math::Vector2f ball_scale;
+
+    math::Vector2f hole_position;
+    math::Vector2f hole_scale;
+
+    std::vector<Tile> tiles;
+
+    std::vector<TextureRef> textures;
+};
+}
+
+#endif // SIM_COURSE_H
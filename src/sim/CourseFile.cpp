@@ -0,0 +1,342 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "CourseFile.h"
+
+#include "Course.h"
+#include "Tile.h"
+
+// The tile section is read in place as an array of sim::Tile
+static_assert(sizeof(sim::Tile) == 4 * sizeof(float), "sim::Tile must be four packed floats");
+static_assert(std::is_trivially_copyable<sim::Tile>::value, "sim::Tile must be trivially copyable");
+static_assert(sizeof(sim::TextureRef) == 64, "sim::TextureRef must stay 64 bytes");
+static_assert(sizeof(sim::CourseHeader) == 64, "sim::CourseHeader must stay 64 bytes");
+
+namespace {
+
+const char MAGIC[4] = {'G', 'O', 'L', 'F'};
+
+const char* SLOT_NAMES[sim::TEXTURE_SLOTS] = {"ball", "hole", "tile", "field"};
+
+// A finite position and a finite positive scale, anything else poisons the grid and the physics
+bool validBox(float x, float y, float w, float h){
+    return std::isfinite(x) && std::isfinite(y) && std::isfinite(w) && std::isfinite(h) && w > 0 && h > 0;
+}
+
+bool validTiles(const sim::Tile* tiles, size_t count){
+    for(size_t i = 0; i < count; i++){
+        math::Vector2f position = tiles[i].getPosition();
+        math::Vector2f scale = tiles[i].getScale();
+        if(!validBox(position.x, position.y, scale.x, scale.y)){
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+sim::CourseFile::CourseFile()
+: data(nullptr), size(0)
+#ifdef _WIN32
+, file_handle(nullptr), mapping_handle(nullptr)
+#endif
+{}
+
+sim::CourseFile::~CourseFile(){
+    close();
+}
+
+bool sim::CourseFile::open(const std::string path){
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE){
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if(!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0){
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping == nullptr){
+        CloseHandle(file);
+        return false;
+    }
+
+    data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(data == nullptr){
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    size = file_size.QuadPart;
+    file_handle = file;
+    mapping_handle = mapping;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) < 0 || info.st_size == 0){
+        ::close(fd);
+        return false;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(mapped == MAP_FAILED){
+        return false;
+    }
+
+    data = (const unsigned char*)mapped;
+    size = info.st_size;
+#endif
+
+    if(!validate()){
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void sim::CourseFile::close(){
+    if(data == nullptr){
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping_handle);
+    CloseHandle(file_handle);
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+#else
+    munmap((void*)data, size);
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
+bool sim::CourseFile::isOpen() const {
+    return data != nullptr;
+}
+
+bool sim::CourseFile::validate() const {
+    if(size < sizeof(CourseHeader)){
+        return false;
+    }
+
+    const CourseHeader& header = getHeader();
+    if(memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+       header.header_size != sizeof(CourseHeader)){
+        return false;
+    }
+
+    if(header.tile_offset % alignof(Tile) != 0 ||
+       header.tile_offset > size || header.tile_count > (size - header.tile_offset) / sizeof(Tile)){
+        return false;
+    }
+
+    if(header.texture_offset % alignof(TextureRef) != 0 ||
+       header.texture_offset > size || header.texture_count > (size - header.texture_offset) / sizeof(TextureRef)){
+        return false;
+    }
+
+    if(header.width <= 0 || header.height <= 0 ||
+       !validBox(header.ball[0], header.ball[1], header.ball[2], header.ball[3]) ||
+       !validBox(header.hole[0], header.hole[1], header.hole[2], header.hole[3])){
+        return false;
+    }
+
+    return validTiles(getTiles(), header.tile_count);
+}
+
+const sim::CourseHeader& sim::CourseFile::getHeader() const {
+    return *(const CourseHeader*)data;
+}
+
+const sim::Tile* sim::CourseFile::getTiles() const {
+    return (const Tile*)(data + getHeader().tile_offset);
+}
+
+size_t sim::CourseFile::getTileCount() const {
+    return getHeader().tile_count;
+}
+
+const sim::TextureRef* sim::CourseFile::getTextures() const {
+    return (const TextureRef*)(data + getHeader().texture_offset);
+}
+
+size_t sim::CourseFile::getTextureCount() const {
+    return getHeader().texture_count;
+}
+
+sim::Course sim::CourseFile::toCourse() const {
+    const CourseHeader& header = getHeader();
+
+    Course course;
+    course.width = header.width;
+    course.height = header.height;
+    course.ball_position = math::Vector2f(header.ball[0], header.ball[1]);
+    course.ball_scale = math::Vector2f(header.ball[2], header.ball[3]);
+    course.hole_position = math::Vector2f(header.hole[0], header.hole[1]);
+    course.hole_scale = math::Vector2f(header.hole[2], header.hole[3]);
+    course.tiles.assign(getTiles(), getTiles() + getTileCount());
+    course.textures.assign(getTextures(), getTextures() + getTextureCount());
+
+    return course;
+}
+
+bool sim::CourseFile::write(const std::string path, const Course& course){
+    CourseHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.header_size = sizeof(CourseHeader);
+    header.width = course.width;
+    header.height = course.height;
+    header.ball[0] = course.ball_position.x;
+    header.ball[1] = course.ball_position.y;
+    header.ball[2] = course.ball_scale.x;
+    header.ball[3] = course.ball_scale.y;
+    header.hole[0] = course.hole_position.x;
+    header.hole[1] = course.hole_position.y;
+    header.hole[2] = course.hole_scale.x;
+    header.hole[3] = course.hole_scale.y;
+    header.tile_count = course.tiles.size();
+    header.tile_offset = sizeof(CourseHeader);
+    header.texture_count = course.textures.size();
+    header.texture_offset = header.tile_offset + header.tile_count * sizeof(Tile);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if(!out){
+        return false;
+    }
+
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)course.tiles.data(), course.tiles.size() * sizeof(Tile));
+    out.write((const char*)course.textures.data(), course.textures.size() * sizeof(TextureRef));
+
+    return (bool)out;
+}
+
+// One record per line: "size w h", "ball x y w h", "hole x y w h", "tile x y w h", "texture <slot> <path>".
+// size, ball and hole appear exactly once
+bool sim::CourseFile::readText(std::istream& in, Course& course){
+    course = Course();
+    int sizes = 0, balls = 0, holes = 0;
+
+    std::string line;
+    if(!std::getline(in, line) || line.rfind("golf-course", 0) != 0){
+        return false;
+    }
+
+    while(std::getline(in, line)){
+        std::istringstream fields(line);
+        std::string key;
+        if(!(fields >> key) || key[0] == '#'){
+            continue;
+        }
+
+        float x, y, w, h;
+        if(key == "size"){
+            if(!(fields >> course.width >> course.height)){
+                return false;
+            }
+            sizes++;
+        }
+        else if(key == "ball" || key == "hole" || key == "tile"){
+            if(!(fields >> x >> y >> w >> h) || !validBox(x, y, w, h)){
+                return false;
+            }
+
+            if(key == "ball"){
+                course.ball_position = math::Vector2f(x, y);
+                course.ball_scale = math::Vector2f(w, h);
+                balls++;
+            }
+            else if(key == "hole"){
+                course.hole_position = math::Vector2f(x, y);
+                course.hole_scale = math::Vector2f(w, h);
+                holes++;
+            }
+            else {
+                course.tiles.push_back(Tile(math::Vector2f(x, y), math::Vector2f(w, h)));
+            }
+        }
+        else if(key == "texture"){
+            std::string slot, path;
+            if(!(fields >> slot >> path) || path.size() >= sizeof(TextureRef::path)){
+                return false;
+            }
+
+            TextureRef ref = {};
+            ref.slot = TEXTURE_SLOTS;
+            for(uint32_t i = 0; i < TEXTURE_SLOTS; i++){
+                if(slot == SLOT_NAMES[i]){
+                    ref.slot = i;
+                }
+            }
+            if(ref.slot == TEXTURE_SLOTS){
+                return false;
+            }
+
+            memcpy(ref.path, path.c_str(), path.size());
+            course.textures.push_back(ref);
+        }
+        else {
+            return false;
+        }
+    }
+
+    return sizes == 1 && balls == 1 && holes == 1 && course.width > 0 && course.height > 0;
+}
+
+void sim::CourseFile::writeText(std::ostream& out, const Course& course){
+    // Nine significant digits round trip any float exactly
+    std::streamsize precision = out.precision(9);
+
+    out << "golf-course " << VERSION << "\n";
+    out << "size " << course.width << " " << course.height << "\n";
+    out << "ball " << course.ball_position.x << " " << course.ball_position.y << " "
+        << course.ball_scale.x << " " << course.ball_scale.y << "\n";
+    out << "hole " << course.hole_position.x << " " << course.hole_position.y << " "
+        << course.hole_scale.x << " " << course.hole_scale.y << "\n";
+
+    for(const TextureRef& ref : course.textures){
+        if(ref.slot < TEXTURE_SLOTS){
+            out << "texture " << SLOT_NAMES[ref.slot] << " " << std::string(ref.path, strnlen(ref.path, sizeof(ref.path))) << "\n";
+        }
+    }
+
+    for(const Tile& tile : course.tiles){
+        out << "tile " << tile.getPosition().x << " " << tile.getPosition().y << " "
+            << tile.getScale().x << " " << tile.getScale().y << "\n";
+    }
+
+    out.precision(precision);
+}
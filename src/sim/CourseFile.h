@@ -0,0 +1,79 @@
+#ifndef SIM_COURSEFILE_H
+#define SIM_COURSEFILE_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "Course.h"
+#include "Tile.h"
+
+namespace sim {
+
+// Binary course layout, little endian, every section 4 byte aligned:
+// CourseHeader, tile_count sim::Tile records (x, y, w, h floats), texture_count TextureRef records
+struct CourseHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t header_size;
+    int32_t width;
+    int32_t height;
+    float ball[4];
+    float hole[4];
+    uint32_t tile_count;
+    uint32_t tile_offset;
+    uint32_t texture_count;
+    uint32_t texture_offset;
+};
+
+// Read only memory mapping of a course file, the tile array is used straight from the mapping
+class CourseFile
+{
+    public:
+        CourseFile();
+
+        ~CourseFile();
+
+        CourseFile(const CourseFile&) = delete;
+        CourseFile& operator=(const CourseFile&) = delete;
+
+        bool open(const std::string path);
+
+        void close();
+
+        bool isOpen() const;
+
+        const CourseHeader& getHeader() const;
+
+        const Tile* getTiles() const;
+
+        size_t getTileCount() const;
+
+        const TextureRef* getTextures() const;
+
+        size_t getTextureCount() const;
+
+        Course toCourse() const;
+
+        static bool write(const std::string path, const Course& course);
+
+        static bool readText(std::istream& in, Course& course);
+
+        static void writeText(std::ostream& out, const Course& course);
+
+        static constexpr uint16_t VERSION = 1;
+
+    private:
+        bool validate() const;
+
+        const unsigned char* data;
+        size_t size;
+
+#ifdef _WIN32
+        void* file_handle;
+        void* mapping_handle;
+#endif
+};
+}
+
+#endif // SIM_COURSEFILE_H
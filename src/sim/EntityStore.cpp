@@ -0,0 +1,103 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EntityStore.h"
+
+#include "../Vector2f.h"
+#include "Ball.h"
+#include "BallBatch.h"
+#include "Body.h"
+
+sim::EntityStore::EntityStore() {}
+
+uint32_t sim::EntityStore::create(const Ball& ball){
+    uint32_t id = sparse.size();
+    sparse.push_back(ids.size());
+    ids.push_back(id);
+
+    motion.add(ball);
+    extent.push_back(ball.getScale());
+
+    return id;
+}
+
+void sim::EntityStore::destroy(uint32_t id){
+    if(!contains(id)){
+        return;
+    }
+
+    size_t removed = sparse[id];
+    motion.erase(removed);
+    extent.erase(extent.begin() + removed);
+    ids.erase(ids.begin() + removed);
+
+    sparse[id] = NONE;
+    for(size_t i = removed; i < ids.size(); i++){
+        sparse[ids[i]] = i;
+    }
+}
+
+void sim::EntityStore::clear(){
+    motion.clear();
+    extent.clear();
+    ids.clear();
+    sparse.clear();
+}
+
+bool sim::EntityStore::contains(uint32_t id) const {
+    return id < sparse.size() && sparse[id] != NONE;
+}
+
+size_t sim::EntityStore::index(uint32_t id) const {
+    return sparse[id];
+}
+
+uint32_t sim::EntityStore::getId(size_t index) const {
+    return ids[index];
+}
+
+size_t sim::EntityStore::size() const {
+    return ids.size();
+}
+
+sim::Ball sim::EntityStore::getBall(size_t index) const {
+    Ball ball(getPosition(index), extent[index]);
+    motion.store(index, ball);
+    return ball;
+}
+
+void sim::EntityStore::setBall(size_t index, const Ball& ball){
+    motion.load(index, ball);
+    extent[index] = ball.getScale();
+}
+
+sim::Body sim::EntityStore::getBody(size_t index) const {
+    return Body(getPosition(index), extent[index]);
+}
+
+math::Vector2f sim::EntityStore::getPosition(size_t index) const {
+    return math::Vector2f(motion.x[index], motion.y[index]);
+}
+
+void sim::EntityStore::setPosition(size_t index, math::Vector2f position){
+    motion.x[index] = position.x;
+    motion.y[index] = position.y;
+}
+
+math::Vector2f sim::EntityStore::getVelocity(size_t index) const {
+    return math::Vector2f(motion.vx[index], motion.vy[index]);
+}
+
+void sim::EntityStore::setVelocity(size_t index, math::Vector2f velocity){
+    motion.vx[index] = velocity.x;
+    motion.vy[index] = velocity.y;
+}
+
+bool sim::EntityStore::isMoving(size_t index) const {
+    return motion.isMoving(index);
+}
+
+void sim::EntityStore::integrate(float dt){
+    motion.update(dt);
+}
@@ -0,0 +1,72 @@
+#ifndef SIM_ENTITYSTORE_H
+#define SIM_ENTITYSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "Ball.h"
+#include "BallBatch.h"
+#include "Body.h"
+
+namespace sim {
+
+// Dense components for every ball on the course, reached through entity ids. Position and velocity are the lanes
+// of motion so integrate() steps them in place, extent runs alongside in the same order.
+// A destroyed entity shifts the ones after it down, they keep creation order and their ids
+class EntityStore
+{
+    public:
+        EntityStore();
+
+        uint32_t create(const Ball& ball);
+
+        void destroy(uint32_t id);
+
+        // Ids start again from 0, the arrays keep their capacity
+        void clear();
+
+        bool contains(uint32_t id) const;
+
+        size_t index(uint32_t id) const;
+
+        uint32_t getId(size_t index) const;
+
+        size_t size() const;
+
+        // Whole balls copied out of the arrays and back, for setting one up and for Trajectory
+        Ball getBall(size_t index) const;
+        void setBall(size_t index, const Ball& ball);
+
+        // Position and extent as a box for overlap and sweep queries
+        Body getBody(size_t index) const;
+
+        math::Vector2f getPosition(size_t index) const;
+        void setPosition(size_t index, math::Vector2f position);
+
+        math::Vector2f getVelocity(size_t index) const;
+        void setVelocity(size_t index, math::Vector2f velocity);
+
+        bool isMoving(size_t index) const;
+
+        // Ball::update for every entity at once
+        void integrate(float dt);
+
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        // Position and velocity
+        BallBatch motion;
+
+        // Size of the transform, also the box the entity collides with
+        std::vector<math::Vector2f> extent;
+
+    private:
+        std::vector<uint32_t> ids;
+
+        // Dense index by id, NONE once destroyed
+        std::vector<uint32_t> sparse;
+};
+}
+
+#endif // SIM_ENTITYSTORE_H
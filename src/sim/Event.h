@@ -0,0 +1,21 @@
+#ifndef SIM_EVENT_H
+#define SIM_EVENT_H
+
+namespace sim {
+
+enum EventType {
+    SWING,
+    WALL_COLLISION,
+    TILE_COLLISION,
+    BALL_COLLISION,
+    HOLE_IN
+};
+
+// Raised by World instead of playing sounds, velocity is the speed of the ball involved when it happened
+struct Event {
+    EventType type;
+    float velocity;
+};
+}
+
+#endif // SIM_EVENT_H
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Generator.h"
+
+#include "../Vector2f.h"
+#include "Course.h"
+#include "Random.h"
+#include "Tile.h"
+#include "ThreadPool.h"
+
+namespace {
+
+bool intersects(float x, float y, float w, float h, math::Vector2f position, math::Vector2f scale, float clearance){
+    return x < position.x + scale.x + clearance && x + w > position.x - clearance &&
+           y < position.y + scale.y + clearance && y + h > position.y - clearance;
+}
+
+}
+
+sim::CourseGenerator::CourseGenerator(GeneratorOptions options)
+: options(options) {}
+
+sim::Course sim::CourseGenerator::generate(uint64_t seed) const {
+    Course course;
+    course.width = options.width;
+    course.height = options.height;
+    course.ball_scale = options.ball_scale;
+    course.hole_scale = options.hole_scale;
+    course.tiles.assign(options.tiles, Tile(math::Vector2f(0, 0), options.tile_scale));
+
+    Random random(seed);
+    place(course, random);
+
+    return course;
+}
+
+void sim::CourseGenerator::place(Course& course, Random& random) const {
+    std::vector<int> cells;
+    place(course, random, cells);
+}
+
+void sim::CourseGenerator::place(Course& course, Random& random, std::vector<int>& cells) const {
+    const int width = course.width;
+    const int height = course.height;
+    const math::Vector2f ball = course.ball_scale;
+    const math::Vector2f hole = course.hole_scale;
+
+    // Ball on the bottom row, hole in the top quarter, same bands App::randomize used
+    course.ball_position = math::Vector2f(random.range(ball.x, width - ball.x), height - ball.y - options.spawn_margin);
+    course.hole_position = math::Vector2f(random.range(hole.x, width - hole.x), random.range(hole.y, height / 4 - hole.y));
+
+    if(course.tiles.empty()){
+        return;
+    }
+
+    float tile_w = 0.0f, tile_h = 0.0f;
+    for(const Tile& tile : course.tiles){
+        tile_w = std::max(tile_w, tile.getScale().x);
+        tile_h = std::max(tile_h, tile.getScale().y);
+    }
+
+    float cell_w = tile_w + options.jitter + options.gap;
+    float cell_h = tile_h + options.jitter + options.gap;
+    int columns = std::max(0, (int)((width + options.gap) / cell_w));
+    int rows = std::max(0, (int)((height + options.gap) / cell_h));
+
+    // Center the grid, the last column and row do not need the trailing gap
+    float left = std::floor((width - (columns * cell_w - options.gap)) / 2.0f);
+    float top = std::floor((height - (rows * cell_h - options.gap)) / 2.0f);
+
+    cells.clear();
+    cells.reserve(columns * rows);
+    for(int row = 0; row < rows; row++){
+        for(int column = 0; column < columns; column++){
+            float x = left + column * cell_w;
+            float y = top + row * cell_h;
+            float w = tile_w + options.jitter, h = tile_h + options.jitter;
+            if(!intersects(x, y, w, h, course.ball_position, ball, options.clearance) &&
+               !intersects(x, y, w, h, course.hole_position, hole, options.clearance)){
+                cells.push_back(row * columns + column);
+            }
+        }
+    }
+
+    size_t placed = std::min(course.tiles.size(), cells.size());
+    course.tiles.resize(placed);
+
+    // Partial Fisher-Yates, each tile gets a distinct cell and a random offset inside it
+    for(size_t i = 0; i < placed; i++){
+        std::swap(cells[i], cells[i + random.below(cells.size() - i)]);
+
+        Tile& tile = course.tiles[i];
+        float x = left + (cells[i] % columns) * cell_w;
+        float y = top + (cells[i] / columns) * cell_h;
+        x += random.below((uint32_t)(tile_w + options.jitter - tile.getScale().x) + 1);
+        y += random.below((uint32_t)(tile_h + options.jitter - tile.getScale().y) + 1);
+
+        tile.setPosition(std::floor(x), std::floor(y));
+    }
+}
+
+std::vector<sim::Course> sim::CourseGenerator::generateBatch(ThreadPool& pool, uint64_t first_seed, size_t count) const {
+    std::vector<Course> courses(count);
+
+    pool.parallelFor(count, 64, [&](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            courses[i] = generate(first_seed + i);
+        }
+    });
+
+    return courses;
+}
@@ -0,0 +1,52 @@
+#ifndef SIM_GENERATOR_H
+#define SIM_GENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Course.h"
+#include "Random.h"
+#include "ThreadPool.h"
+
+namespace sim {
+
+struct GeneratorOptions {
+    int width = 480;
+    int height = 640;
+
+    math::Vector2f ball_scale = math::Vector2f(16, 16);
+    math::Vector2f hole_scale = math::Vector2f(16, 16);
+    math::Vector2f tile_scale = math::Vector2f(64, 64);
+    int tiles = 5;
+
+    float spawn_margin = 30.0f;     // gap between the ball and the bottom wall
+    float clearance = 24.0f;        // free space kept around the ball spawn and the hole
+    float gap = 8.0f;               // minimum space between two tiles
+    float jitter = 24.0f;           // how far a tile can move around inside its cell
+};
+
+// Grid jittered layout: the field is cut into cells one tile plus gap and jitter wide, the tiles go into
+// distinct random cells clear of the spawn and the hole, so placement never retries and never overlaps
+class CourseGenerator
+{
+    public:
+        CourseGenerator(GeneratorOptions options = GeneratorOptions());
+
+        Course generate(uint64_t seed) const;
+
+        // Places the ball, hole and the tiles already in course keeping their sizes,
+        // tiles that find no free cell are dropped
+        void place(Course& course, Random& random) const;
+
+        // Same, with the free cell list in a buffer the caller keeps between calls so nothing is allocated
+        void place(Course& course, Random& random, std::vector<int>& cells) const;
+
+        // Course i comes from seed first_seed + i, whatever the thread count
+        std::vector<Course> generateBatch(ThreadPool& pool, uint64_t first_seed, size_t count) const;
+
+    private:
+        GeneratorOptions options;
+};
+}
+
+#endif // SIM_GENERATOR_H
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Grid.h"
+
+#include "Tile.h"
+
+sim::Grid::Grid() {}
+
+void sim::Grid::build(const std::vector<Tile>& tiles, int width, int height, float cell_size){
+    // Default to the largest tile so most tiles land in at most four cells
+    if(cell_size <= 0.0f){
+        cell_size = 64.0f;
+        for(const Tile& tile : tiles){
+            cell_size = std::max(cell_size, std::max(tile.getScale().x, tile.getScale().y));
+        }
+    }
+
+    this->cell_size = cell_size;
+    columns = std::max(1, (int)std::ceil(width / cell_size));
+    rows = std::max(1, (int)std::ceil(height / cell_size));
+
+    cell_start.assign(columns * rows + 1, 0);
+
+    for(const Tile& tile : tiles){
+        int x0 = cellX(tile.getPosition().x), x1 = cellX(tile.getPosition().x + tile.getScale().x);
+        int y0 = cellY(tile.getPosition().y), y1 = cellY(tile.getPosition().y + tile.getScale().y);
+        for(int y = y0; y <= y1; y++){
+            for(int x = x0; x <= x1; x++){
+                cell_start[y * columns + x + 1]++;
+            }
+        }
+    }
+
+    for(int i = 0; i < columns * rows; i++){
+        cell_start[i + 1] += cell_start[i];
+    }
+
+    cell_tiles.resize(cell_start.back());
+    fill.assign(cell_start.begin(), cell_start.end() - 1);
+
+    for(size_t i = 0; i < tiles.size(); i++){
+        const Tile& tile = tiles[i];
+        int x0 = cellX(tile.getPosition().x), x1 = cellX(tile.getPosition().x + tile.getScale().x);
+        int y0 = cellY(tile.getPosition().y), y1 = cellY(tile.getPosition().y + tile.getScale().y);
+        for(int y = y0; y <= y1; y++){
+            for(int x = x0; x <= x1; x++){
+                cell_tiles[fill[y * columns + x]++] = i;
+            }
+        }
+    }
+}
+
+void sim::Grid::query(float min_x, float min_y, float max_x, float max_y, std::vector<int>& out) const {
+    if(columns == 0){
+        return;
+    }
+
+    int x0 = cellX(min_x), x1 = cellX(max_x);
+    int y0 = cellY(min_y), y1 = cellY(max_y);
+
+    size_t first = out.size();
+    for(int y = y0; y <= y1; y++){
+        for(int x = x0; x <= x1; x++){
+            int cell = y * columns + x;
+            out.insert(out.end(), cell_tiles.begin() + cell_start[cell], cell_tiles.begin() + cell_start[cell + 1]);
+        }
+    }
+
+    // One cell is already sorted, several can repeat tiles that straddle a border
+    if(x0 != x1 || y0 != y1){
+        std::sort(out.begin() + first, out.end());
+        out.erase(std::unique(out.begin() + first, out.end()), out.end());
+    }
+}
+
+float sim::Grid::getCellSize() const {
+    return cell_size;
+}
+
+// Anything off the field is clamped into the border cells so queries stay conservative
+int sim::Grid::cellX(float x) const {
+    if(!(x > 0.0f)){
+        return 0;
+    }
+    float cell = x / cell_size;
+    return cell >= columns ? columns - 1 : (int)cell;
+}
+
+int sim::Grid::cellY(float y) const {
+    if(!(y > 0.0f)){
+        return 0;
+    }
+    float cell = y / cell_size;
+    return cell >= rows ? rows - 1 : (int)cell;
+}
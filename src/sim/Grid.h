@@ -0,0 +1,39 @@
+#ifndef SIM_GRID_H
+#define SIM_GRID_H
+
+#include <vector>
+
+#include "Tile.h"
+
+namespace sim {
+
+// Uniform grid over the field, every cell lists the tiles touching it in tile order
+class Grid
+{
+    public:
+        Grid();
+
+        void build(const std::vector<Tile>& tiles, int width, int height, float cell_size = 0.0f);
+
+        // Appends the indices of every tile that may touch the box, ascending and without duplicates
+        void query(float min_x, float min_y, float max_x, float max_y, std::vector<int>& out) const;
+
+        float getCellSize() const;
+
+    private:
+        int cellX(float x) const;
+        int cellY(float y) const;
+
+        float cell_size = 64.0f;
+        int columns = 0;
+        int rows = 0;
+
+        std::vector<int> cell_start;
+        std::vector<int> cell_tiles;
+
+        // Write cursor per cell while building, kept so rebuilding allocates nothing
+        std::vector<int> fill;
+};
+}
+
+#endif // SIM_GRID_H
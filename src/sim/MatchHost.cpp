@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "MatchHost.h"
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "Event.h"
+#include "Session.h"
+#include "Recording.h"
+#include "Protocol.h"
+#include "ThreadPool.h"
+
+namespace {
+
+// Randomized courses only, a match never touches the disk
+sim::Recording matchSetup(const sim::Recording& setup, uint64_t seed, uint16_t balls){
+    sim::Recording match = setup;
+    match.seed = seed;
+    match.balls = balls;
+    match.courses.clear();
+    return match;
+}
+}
+
+sim::MatchHost::Match::Match(uint32_t id, uint32_t owner, const Recording& setup)
+: id(id), owner(owner), session(setup), moving_index(NOT_MOVING) {}
+
+sim::MatchHost::MatchHost(ThreadPool& pool, const Recording& setup, size_t max_matches)
+: pool(pool), setup(setup), max_matches(std::min<size_t>(max_matches, UINT32_MAX - 1)) {}
+
+void sim::MatchHost::create(uint32_t owner, uint32_t tag, uint64_t seed, uint16_t balls){
+    if(matches.size() >= max_matches){
+        reject(owner, 0, tag, RejectReason::FULL);
+        return;
+    }
+    if(balls > MAX_BALLS){
+        reject(owner, 0, tag, RejectReason::TOO_MANY_BALLS);
+        return;
+    }
+
+    // Ids wrap after four billion matches, a long lived one may still hold the next
+    uint32_t id = next_id;
+    while(matches.count(id) != 0){
+        id = id == UINT32_MAX ? 1 : id + 1;
+    }
+    next_id = id == UINT32_MAX ? 1 : id + 1;
+
+    matches[id] = std::unique_ptr<Match>(new Match(id, owner, matchSetup(setup, seed, balls)));
+
+    Message message;
+    message.type = MessageType::CREATED;
+    message.tag = tag;
+    message.match = id;
+    outbox.push_back({owner, message});
+}
+
+void sim::MatchHost::shoot(uint32_t owner, uint32_t match, math::Vector2f aim){
+    Match* found = find(owner, match);
+    if(found == nullptr){
+        reject(owner, match, 0, RejectReason::UNKNOWN_MATCH);
+        return;
+    }
+
+    // The other balls may still be rolling from the last shot even with the player's at rest
+    World& world = found->session.getWorld();
+    if(found->moving_index != NOT_MOVING){
+        reject(owner, match, 0, RejectReason::MOVING);
+        return;
+    }
+    if(world.hasWon()){
+        reject(owner, match, 0, RejectReason::FINISHED);
+        return;
+    }
+    // Straight off the wire, a NaN would leave the ball rolling forever
+    if(!std::isfinite(aim.x) || !std::isfinite(aim.y)){
+        reject(owner, match, 0, RejectReason::INVALID_AIM);
+        return;
+    }
+    if(!found->session.shoot(aim)){
+        reject(owner, match, 0, RejectReason::WEAK);
+        return;
+    }
+
+    // The swing goes out before anything the next step raises
+    std::vector<Message> swing;
+    collect(*found, swing);
+    for(const Message& message : swing){
+        outbox.push_back({owner, message});
+    }
+
+    startMoving(*found);
+}
+
+void sim::MatchHost::close(uint32_t owner, uint32_t match){
+    if(find(owner, match) == nullptr){
+        reject(owner, match, 0, RejectReason::UNKNOWN_MATCH);
+        return;
+    }
+
+    remove(match);
+}
+
+void sim::MatchHost::closeAll(uint32_t owner){
+    std::vector<uint32_t> owned;
+    for(const auto& entry : matches){
+        if(entry.second->owner == owner){
+            owned.push_back(entry.first);
+        }
+    }
+
+    for(uint32_t id : owned){
+        remove(id);
+    }
+}
+
+void sim::MatchHost::step(){
+    if(moving.empty()){
+        return;
+    }
+
+    // Matches share nothing, so the pool steps them without any locking. A few tasks per
+    // worker leave room for stealing when some matches have more balls rolling than others
+    size_t grain = std::max(GRAIN, moving.size() / (pool.size() * 4));
+    pool.parallelFor(moving.size(), grain, [this](size_t begin, size_t end){
+        for(size_t i = begin; i < end; i++){
+            Match& match = *moving[i];
+            match.session.step();
+            collect(match, match.pending);
+        }
+    });
+    match_ticks += moving.size();
+
+    for(size_t i = 0; i < moving.size();){
+        Match& match = *moving[i];
+        for(const Message& message : match.pending){
+            outbox.push_back({match.owner, message});
+        }
+        match.pending.clear();
+
+        const World& world = match.session.getWorld();
+        if(world.isMoving()){
+            i++;
+            continue;
+        }
+
+        Message result;
+        result.type = MessageType::RESULT;
+        result.match = match.id;
+        result.tick = match.session.getTick();
+        result.strokes = (uint16_t)match.session.getShots();
+        result.holed = world.hasWon();
+        outbox.push_back({match.owner, result});
+
+        // Swaps the last moving match into i, which has stepped as well and is looked at next
+        stopMoving(match);
+    }
+}
+
+const std::vector<sim::Delivery>& sim::MatchHost::getOutbox() const {
+    return outbox;
+}
+
+void sim::MatchHost::clearOutbox(){
+    outbox.clear();
+}
+
+size_t sim::MatchHost::size() const {
+    return matches.size();
+}
+
+size_t sim::MatchHost::getMovingCount() const {
+    return moving.size();
+}
+
+uint64_t sim::MatchHost::getMatchTicks() const {
+    return match_ticks;
+}
+
+sim::MatchHost::Match* sim::MatchHost::find(uint32_t owner, uint32_t match){
+    auto it = matches.find(match);
+    if(it == matches.end() || it->second->owner != owner){
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+void sim::MatchHost::reject(uint32_t owner, uint32_t match, uint32_t tag, RejectReason reason){
+    Message message;
+    message.type = MessageType::REJECTED;
+    message.match = match;
+    message.tag = tag;
+    message.reason = reason;
+    outbox.push_back({owner, message});
+}
+
+void sim::MatchHost::collect(Match& match, std::vector<Message>& out){
+    World& world = match.session.getWorld();
+    for(const Event& event : world.getEvents()){
+        Message message;
+        message.type = MessageType::EVENT;
+        message.match = match.id;
+        message.tick = match.session.getTick();
+        message.event = (uint8_t)event.type;
+        message.velocity = event.velocity;
+        out.push_back(message);
+    }
+    world.clearEvents();
+}
+
+void sim::MatchHost::startMoving(Match& match){
+    match.moving_index = moving.size();
+    moving.push_back(&match);
+}
+
+void sim::MatchHost::stopMoving(Match& match){
+    size_t index = match.moving_index;
+    moving[index] = moving.back();
+    moving[index]->moving_index = index;
+    moving.pop_back();
+    match.moving_index = NOT_MOVING;
+}
+
+void sim::MatchHost::remove(uint32_t id){
+    auto it = matches.find(id);
+    if(it->second->moving_index != NOT_MOVING){
+        stopMoving(*it->second);
+    }
+    matches.erase(it);
+}
@@ -0,0 +1,104 @@
+#ifndef SIM_MATCHHOST_H
+#define SIM_MATCHHOST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "Session.h"
+#include "Recording.h"
+#include "Protocol.h"
+#include "ThreadPool.h"
+
+namespace sim {
+
+// A message for the connection that owns the match it is about
+struct Delivery {
+    uint32_t owner;
+    Message message;
+};
+
+// Many independent games for the match server, each a Session on its own randomized course. Knows nothing
+// about sockets: requests come in as calls tagged with the connection that made them, and everything to
+// send back piles up in the outbox until the caller clears it, the way World keeps its events
+class MatchHost
+{
+    public:
+        // setup gives the field and body sizes every match shares, seed and balls come with each CREATE.
+        // Ids are 32 bit and never 0, so max_matches stops short of that
+        MatchHost(ThreadPool& pool, const Recording& setup, size_t max_matches = 100000);
+
+        void create(uint32_t owner, uint32_t tag, uint64_t seed, uint16_t balls);
+        void shoot(uint32_t owner, uint32_t match, math::Vector2f aim);
+        void close(uint32_t owner, uint32_t match);
+
+        // Drops every match of a connection that went away
+        void closeAll(uint32_t owner);
+
+        // One tick for every match with a ball rolling, on the pool. Matches at rest cost nothing
+        void step();
+
+        const std::vector<Delivery>& getOutbox() const;
+        void clearOutbox();
+
+        size_t size() const;
+
+        // Matches step() has work for
+        size_t getMovingCount() const;
+
+        // Match ticks run by step() so far, summed over matches
+        uint64_t getMatchTicks() const;
+
+        // Most balls a CREATE may ask for, placing them takes time quadratic in the count on the server loop
+        static constexpr uint16_t MAX_BALLS = 64;
+
+        // Fewest matches one task of step() takes, a task per match would cost more than the stepping
+        static constexpr size_t GRAIN = 16;
+
+    private:
+        struct Match {
+            Match(uint32_t id, uint32_t owner, const Recording& setup);
+
+            uint32_t id;
+            uint32_t owner;
+            Session session;
+
+            // Index in moving, or NOT_MOVING
+            size_t moving_index;
+
+            // Filled by the pool during step(), so no two tasks share a vector
+            std::vector<Message> pending;
+        };
+
+        Match* find(uint32_t owner, uint32_t match);
+
+        void reject(uint32_t owner, uint32_t match, uint32_t tag, RejectReason reason);
+
+        // Moves the world's events into out as EVENT messages
+        static void collect(Match& match, std::vector<Message>& out);
+
+        void startMoving(Match& match);
+        void stopMoving(Match& match);
+
+        void remove(uint32_t id);
+
+        static constexpr size_t NOT_MOVING = SIZE_MAX;
+
+        ThreadPool& pool;
+        Recording setup;
+        size_t max_matches;
+
+        std::unordered_map<uint32_t, std::unique_ptr<Match>> matches;
+        uint32_t next_id = 1;
+
+        std::vector<Match*> moving;
+        uint64_t match_ticks = 0;
+
+        std::vector<Delivery> outbox;
+};
+}
+
+#endif // SIM_MATCHHOST_H
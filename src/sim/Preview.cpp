@@ -0,0 +1,133 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Preview.h"
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "EntityStore.h"
+#include "Event.h"
+#include "Course.h"
+#include "Profiler.h"
+
+sim::Preview::Preview(float dt, int max_bounces, float spacing)
+: dt(dt), max_bounces(max_bounces), spacing(spacing) {}
+
+void sim::Preview::setCourse(const Course& course){
+    this->course.load(course);
+
+    for(Entry& entry : cache){
+        entry.valid = false;
+    }
+    last = nullptr;
+    runs = 0;
+}
+
+const std::vector<math::Vector2f>& sim::Preview::predict(math::Vector2f aim){
+    // Mouse positions one pixel apart give aims one apart, so every bucket holds exactly one of them
+    int32_t x = (int32_t)std::floor(aim.x);
+    int32_t y = (int32_t)std::floor(aim.y);
+
+    clock++;
+    if(last != nullptr && last->x == x && last->y == y){
+        last->used = clock;
+        return last->dots;
+    }
+
+    Entry* oldest = &cache[0];
+    for(Entry& entry : cache){
+        if(entry.valid && entry.x == x && entry.y == y){
+            entry.used = clock;
+            last = &entry;
+            return entry.dots;
+        }
+        if(!entry.valid || (oldest->valid && entry.used < oldest->used)){
+            oldest = &entry;
+        }
+    }
+
+    oldest->x = x;
+    oldest->y = y;
+    oldest->used = clock;
+    oldest->valid = true;
+    run(aim, oldest->dots);
+
+    last = oldest;
+    return oldest->dots;
+}
+
+void sim::Preview::setMaxBounces(int max_bounces){
+    if(this->max_bounces != max_bounces){
+        this->max_bounces = max_bounces;
+        for(Entry& entry : cache){
+            entry.valid = false;
+        }
+        last = nullptr;
+    }
+}
+
+int sim::Preview::getMaxBounces() const {
+    return max_bounces;
+}
+
+uint64_t sim::Preview::getRunCount() const {
+    return runs;
+}
+
+void sim::Preview::run(math::Vector2f aim, std::vector<math::Vector2f>& dots){
+    PROFILE_SCOPE("preview");
+    runs++;
+
+    // Copy assignment keeps the capacity of world's vectors, after the first run this allocates nothing
+    world = course;
+    dots.clear();
+
+    // Too weak to move the ball, nothing to show
+    if(!world.shoot(aim)){
+        return;
+    }
+    world.clearEvents();
+
+    const EntityStore& entities = world.getEntities();
+    math::Vector2f from = entities.getBody(0).getCenter();
+
+    // Distance from the last dot, dots are spread evenly along the path rather than one per tick
+    float carried = 0.0f;
+    int bounces = 0;
+
+    for(int tick = 0; tick < MAX_TICKS && entities.isMoving(0); tick++){
+        world.step(dt);
+
+        bool done = false;
+        for(const Event& event : world.getEvents()){
+            if(event.type == EventType::HOLE_IN){
+                done = true;
+            }
+            else if(event.type == EventType::WALL_COLLISION || event.type == EventType::TILE_COLLISION){
+                done = done || ++bounces > max_bounces;
+            }
+        }
+        world.clearEvents();
+
+        math::Vector2f to = entities.getBody(0).getCenter();
+        math::Vector2f delta = to - from;
+        float length = delta.magnitude();
+
+        float along = spacing - carried;
+        while(along <= length){
+            dots.push_back(from + delta * (along / length));
+            along += spacing;
+        }
+        carried = length - (along - spacing);
+        from = to;
+
+        if(done){
+            break;
+        }
+    }
+
+    // Always show where it ends up
+    dots.push_back(from);
+}
@@ -0,0 +1,67 @@
+#ifndef SIM_PREVIEW_H
+#define SIM_PREVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "Course.h"
+
+namespace sim {
+
+// Where a shot is going to go: the real World steps run ahead on a private copy of the course, up to
+// a number of wall and tile bounces. Aims are bucketed by whole pixels, the finest a mouse drag can make,
+// and the last CACHE_SIZE buckets keep their paths, so holding the mouse still costs a lookup.
+// Other balls are left out, the preview is about the walls and tiles
+class Preview
+{
+    public:
+        // spacing is the distance between the dots of a path
+        Preview(float dt, int max_bounces = 3, float spacing = 12.0f);
+
+        // Throws away every cached path, needed for a new hole or when the ball comes to rest somewhere else
+        void setCourse(const Course& course);
+
+        // Ball centers along the path of a shot with aim, spacing apart, ending at the bounce after
+        // max_bounces, where the ball stops or in the hole. Valid until the next call
+        const std::vector<math::Vector2f>& predict(math::Vector2f aim);
+
+        void setMaxBounces(int max_bounces);
+        int getMaxBounces() const;
+
+        // Paths computed rather than found in the cache since the last setCourse
+        uint64_t getRunCount() const;
+
+        static constexpr size_t CACHE_SIZE = 64;
+
+        // A shot is never followed further than this, about ten seconds at the default tick rate
+        static constexpr int MAX_TICKS = 600;
+
+    private:
+        struct Entry {
+            int32_t x, y;
+            uint64_t used = 0;
+            bool valid = false;
+            std::vector<math::Vector2f> dots;
+        };
+
+        void run(math::Vector2f aim, std::vector<math::Vector2f>& dots);
+
+        float dt;
+        int max_bounces;
+        float spacing;
+
+        // The course loaded once, copied into world for every run so the broadphase is never rebuilt
+        World course;
+        World world;
+
+        Entry cache[CACHE_SIZE];
+        Entry* last = nullptr;
+        uint64_t clock = 0;
+        uint64_t runs = 0;
+};
+}
+
+#endif // SIM_PREVIEW_H
@@ -0,0 +1,172 @@
+#include "Profiler.h"
+
+#ifdef PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace {
+
+uint32_t threadIndex(){
+    static std::atomic<uint32_t> next(0);
+    thread_local uint32_t index = next++;
+    return index;
+}
+}
+
+sim::Profiler::Profiler()
+: slots(new Slot[CAPACITY]), head(0), epoch(std::chrono::steady_clock::now()) {
+    for(size_t i = 0; i < CAPACITY; i++){
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+sim::Profiler& sim::Profiler::get(){
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t sim::Profiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void sim::Profiler::record(const char* name, uint64_t start, uint64_t duration){
+    push(name, start, duration, false);
+}
+
+void sim::Profiler::count(const char* name, uint64_t value){
+    push(name, now(), value, true);
+}
+
+// Odd sequence while the slot is written, 2 * (index + 1) once sample index is complete
+void sim::Profiler::push(const char* name, uint64_t start, uint64_t duration, bool counter){
+    uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[index & (CAPACITY - 1)];
+
+    slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.thread.store(threadIndex(), std::memory_order_relaxed);
+    slot.counter.store(counter, std::memory_order_relaxed);
+
+    slot.sequence.store(index * 2 + 2, std::memory_order_release);
+}
+
+std::vector<sim::ProfileSample> sim::Profiler::snapshot() const {
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+
+    std::vector<ProfileSample> samples;
+    samples.reserve(end - begin);
+
+    for(uint64_t index = begin; index < end; index++){
+        const Slot& slot = slots[index & (CAPACITY - 1)];
+
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if(before != index * 2 + 2){
+            continue;
+        }
+
+        ProfileSample sample;
+        sample.name = slot.name.load(std::memory_order_relaxed);
+        sample.start = slot.start.load(std::memory_order_relaxed);
+        sample.duration = slot.duration.load(std::memory_order_relaxed);
+        sample.thread = slot.thread.load(std::memory_order_relaxed);
+        sample.counter = slot.counter.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(slot.sequence.load(std::memory_order_relaxed) != before){
+            continue;
+        }
+
+        samples.push_back(sample);
+    }
+
+    return samples;
+}
+
+std::vector<sim::PhaseStats> sim::Profiler::stats() const {
+    std::vector<ProfileSample> samples = snapshot();
+
+    std::vector<const char*> names;
+    std::vector<std::vector<double>> values;
+    std::vector<bool> counters;
+
+    for(const ProfileSample& sample : samples){
+        size_t phase = 0;
+        while(phase < names.size() && strcmp(names[phase], sample.name) != 0){
+            phase++;
+        }
+        if(phase == names.size()){
+            names.push_back(sample.name);
+            values.emplace_back();
+            counters.push_back(sample.counter);
+        }
+        values[phase].push_back(sample.counter ? (double)sample.duration : sample.duration / 1000000.0);
+    }
+
+    std::vector<PhaseStats> result;
+    for(size_t phase = 0; phase < names.size(); phase++){
+        std::vector<double>& v = values[phase];
+        std::sort(v.begin(), v.end());
+
+        double sum = 0.0;
+        for(double x : v){
+            sum += x;
+        }
+
+        size_t p99 = (size_t)std::ceil(v.size() * 0.99) - 1;
+        result.push_back({names[phase], v.size(), v.front(), sum / v.size(), v[p99], v.back(), counters[phase]});
+    }
+
+    return result;
+}
+
+bool sim::Profiler::writeTrace(const std::string path) const {
+    std::ofstream out(path);
+    if(!out){
+        return false;
+    }
+
+    std::vector<ProfileSample> samples = snapshot();
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for(size_t i = 0; i < samples.size(); i++){
+        const ProfileSample& sample = samples[i];
+        if(i > 0){
+            out << ",";
+        }
+        out << "\n{\"name\":\"" << sample.name << "\",\"pid\":1,\"tid\":" << sample.thread
+            << ",\"ts\":" << sample.start / 1000.0;
+        if(sample.counter){
+            out << ",\"ph\":\"C\",\"args\":{\"value\":" << sample.duration << "}}";
+        }
+        else {
+            out << ",\"ph\":\"X\",\"dur\":" << sample.duration / 1000.0 << "}";
+        }
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
+
+void sim::Profiler::clear(){
+    uint64_t end = head.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    for(uint64_t index = begin; index < end; index++){
+        slots[index & (CAPACITY - 1)].sequence.store(0, std::memory_order_release);
+    }
+}
+
+#endif // PROFILING
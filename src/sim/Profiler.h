@@ -0,0 +1,110 @@
+#ifndef SIM_PROFILER_H
+#define SIM_PROFILER_H
+
+// Debug builds only, release (-DNDEBUG) compiles every probe away
+#ifndef NDEBUG
+#define PROFILING 1
+#endif
+
+#ifdef PROFILING
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+struct ProfileSample {
+    const char* name;
+    uint64_t start;     // ns since the profiler started
+    uint64_t duration;  // ns, or the value for counters
+    uint32_t thread;
+    bool counter;
+};
+
+struct PhaseStats {
+    std::string name;
+    size_t count;
+    double min, avg, p99, max;  // ms, or plain values for counters
+    bool counter;
+};
+
+// Process wide ring of the most recent samples. Writers never block: each claims a slot with one
+// fetch_add and publishes it through a per slot sequence number, readers skip slots caught mid write
+class Profiler
+{
+    public:
+        static Profiler& get();
+
+        uint64_t now() const;
+
+        // name must outlive the profiler, string literals in practice
+        void record(const char* name, uint64_t start, uint64_t duration);
+
+        void count(const char* name, uint64_t value);
+
+        // Samples still in the ring, oldest first
+        std::vector<ProfileSample> snapshot() const;
+
+        // Per name summary of the current snapshot, in order of first appearance
+        std::vector<PhaseStats> stats() const;
+
+        // Chrome / Perfetto trace event JSON
+        bool writeTrace(const std::string path) const;
+
+        void clear();
+
+        static constexpr size_t CAPACITY = 1 << 14;
+
+    private:
+        Profiler();
+
+        void push(const char* name, uint64_t start, uint64_t duration, bool counter);
+
+        struct Slot {
+            std::atomic<uint64_t> sequence;
+            std::atomic<const char*> name;
+            std::atomic<uint64_t> start;
+            std::atomic<uint64_t> duration;
+            std::atomic<uint32_t> thread;
+            std::atomic<bool> counter;
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head;
+        std::chrono::steady_clock::time_point epoch;
+};
+
+class ProfileScope
+{
+    public:
+        ProfileScope(const char* name)
+        : name(name), start(Profiler::get().now()) {}
+
+        ~ProfileScope(){
+            Profiler& profiler = Profiler::get();
+            profiler.record(name, start, profiler.now() - start);
+        }
+
+    private:
+        const char* name;
+        uint64_t start;
+};
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) sim::ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define PROFILE_COUNT(name, value) sim::Profiler::get().count(name, value)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNT(name, value) ((void)sizeof(value))
+
+#endif // PROFILING
+
+#endif // SIM_PROFILER_H
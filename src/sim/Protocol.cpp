@@ -0,0 +1,154 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "Protocol.h"
+
+namespace {
+
+void putFixed(std::string& out, uint64_t value, int bytes){
+    for(int i = 0; i < bytes; i++){
+        out.push_back((char)(value >> (i * 8)));
+    }
+}
+
+void putFloat(std::string& out, float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putFixed(out, bits, 4);
+}
+
+// Callers check the whole payload is there first, so unlike the recording reader this one never runs out
+struct Reader {
+    const char* data;
+
+    uint64_t fixed(int bytes){
+        uint64_t value = 0;
+        for(int i = 0; i < bytes; i++){
+            value |= (uint64_t)(uint8_t)data[i] << (i * 8);
+        }
+        data += bytes;
+        return value;
+    }
+
+    float real(){
+        uint32_t bits = (uint32_t)fixed(4);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+// Payload bytes after the type byte, -1 for types nobody sends
+int payloadSize(uint8_t type){
+    switch((sim::MessageType)type){
+        case sim::MessageType::CREATE:   return 14;
+        case sim::MessageType::SHOT:     return 12;
+        case sim::MessageType::CLOSE:    return 4;
+        case sim::MessageType::CREATED:  return 8;
+        case sim::MessageType::EVENT:    return 13;
+        case sim::MessageType::RESULT:   return 11;
+        case sim::MessageType::REJECTED: return 9;
+    }
+    return -1;
+}
+}
+
+void sim::encode(const Message& message, std::string& out){
+    out.push_back((char)message.type);
+
+    switch(message.type){
+        case MessageType::CREATE:
+            putFixed(out, message.tag, 4);
+            putFixed(out, message.seed, 8);
+            putFixed(out, message.balls, 2);
+            break;
+        case MessageType::SHOT:
+            putFixed(out, message.match, 4);
+            putFloat(out, message.x);
+            putFloat(out, message.y);
+            break;
+        case MessageType::CLOSE:
+            putFixed(out, message.match, 4);
+            break;
+        case MessageType::CREATED:
+            putFixed(out, message.tag, 4);
+            putFixed(out, message.match, 4);
+            break;
+        case MessageType::EVENT:
+            putFixed(out, message.match, 4);
+            putFixed(out, message.tick, 4);
+            putFixed(out, message.event, 1);
+            putFloat(out, message.velocity);
+            break;
+        case MessageType::RESULT:
+            putFixed(out, message.match, 4);
+            putFixed(out, message.tick, 4);
+            putFixed(out, message.strokes, 2);
+            putFixed(out, message.holed, 1);
+            break;
+        case MessageType::REJECTED:
+            putFixed(out, message.match, 4);
+            putFixed(out, message.tag, 4);
+            putFixed(out, (uint8_t)message.reason, 1);
+            break;
+    }
+}
+
+int sim::decode(const char* data, size_t size, Message& message){
+    if(size < 1){
+        return 0;
+    }
+
+    int payload = payloadSize((uint8_t)data[0]);
+    if(payload < 0){
+        return -1;
+    }
+    if(size < (size_t)payload + 1){
+        return 0;
+    }
+
+    message = Message();
+    message.type = (MessageType)data[0];
+    Reader reader = {data + 1};
+
+    switch(message.type){
+        case MessageType::CREATE:
+            message.tag = (uint32_t)reader.fixed(4);
+            message.seed = reader.fixed(8);
+            message.balls = (uint16_t)reader.fixed(2);
+            break;
+        case MessageType::SHOT:
+            message.match = (uint32_t)reader.fixed(4);
+            message.x = reader.real();
+            message.y = reader.real();
+            break;
+        case MessageType::CLOSE:
+            message.match = (uint32_t)reader.fixed(4);
+            break;
+        case MessageType::CREATED:
+            message.tag = (uint32_t)reader.fixed(4);
+            message.match = (uint32_t)reader.fixed(4);
+            break;
+        case MessageType::EVENT:
+            message.match = (uint32_t)reader.fixed(4);
+            message.tick = (uint32_t)reader.fixed(4);
+            message.event = (uint8_t)reader.fixed(1);
+            message.velocity = reader.real();
+            break;
+        case MessageType::RESULT:
+            message.match = (uint32_t)reader.fixed(4);
+            message.tick = (uint32_t)reader.fixed(4);
+            message.strokes = (uint16_t)reader.fixed(2);
+            message.holed = reader.fixed(1) != 0;
+            break;
+        case MessageType::REJECTED:
+            message.match = (uint32_t)reader.fixed(4);
+            message.tag = (uint32_t)reader.fixed(4);
+            message.reason = (RejectReason)reader.fixed(1);
+            break;
+    }
+
+    return payload + 1;
+}
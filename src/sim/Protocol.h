@@ -0,0 +1,65 @@
+#ifndef SIM_PROTOCOL_H
+#define SIM_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace sim {
+
+// Match server wire format: a type byte followed by that type's fixed size payload, little endian.
+// Clients send the first three, the server answers with the rest
+enum class MessageType : uint8_t {
+    CREATE = 1,     // tag, seed, balls
+    SHOT = 2,       // match, x, y
+    CLOSE = 3,      // match
+
+    CREATED = 16,   // tag, match
+    EVENT = 17,     // match, tick, event, velocity
+    RESULT = 18,    // match, tick, strokes, holed, once every ball has stopped after a shot
+    REJECTED = 19   // match, tag, reason, the tag of the CREATE when that was refused
+};
+
+enum class RejectReason : uint8_t {
+    UNKNOWN_MATCH = 1,  // never created, closed or owned by another connection
+    MOVING = 2,         // shot before the last one came to rest
+    WEAK = 3,           // aim too short to move the ball, World::shoot
+    FINISHED = 4,       // the ball is already in
+    FULL = 5,           // the server hosts as many matches as it allows
+    TOO_MANY_BALLS = 6, // a CREATE asking for more than MatchHost::MAX_BALLS
+    INVALID_AIM = 7     // an aim with a NaN or infinite component
+};
+
+// Flat on purpose, each type uses the fields its comment above lists and leaves the rest alone
+struct Message {
+    MessageType type = MessageType::CREATE;
+
+    uint32_t match = 0;
+    uint32_t tag = 0;       // chosen by the client, echoed back so it can pair CREATED with its CREATE
+    uint64_t seed = 0;
+    uint16_t balls = 0;     // World::setScatter
+
+    float x = 0.0f, y = 0.0f;   // World::shoot aim
+
+    uint32_t tick = 0;      // ticks the match has run
+    uint8_t event = 0;      // EventType
+    float velocity = 0.0f;
+
+    uint16_t strokes = 0;
+    bool holed = false;
+
+    RejectReason reason = RejectReason::UNKNOWN_MATCH;
+};
+
+// Appends the frame for message to out
+void encode(const Message& message, std::string& out);
+
+// Reads the frame starting at data. Returns its size, 0 when size bytes only hold part of it
+// and -1 for an unknown type, after which the stream cannot be trusted
+int decode(const char* data, size_t size, Message& message);
+
+// Largest frame encode writes
+constexpr size_t MAX_FRAME = 15;
+}
+
+#endif // SIM_PROTOCOL_H
@@ -0,0 +1,78 @@
+#ifndef SIM_RANDOM_H
+#define SIM_RANDOM_H
+
+#include <cstdint>
+
+namespace sim {
+
+// xoshiro256** seeded through splitmix64, the same seed gives the same sequence on every platform
+class Random
+{
+    public:
+        Random(uint64_t seed = 0){
+            this->seed(seed);
+        }
+
+        void seed(uint64_t seed){
+            for(uint64_t& word : state){
+                seed += 0x9E3779B97F4A7C15ull;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        uint64_t next(){
+            uint64_t result = rotl(state[1] * 5, 7) * 9;
+            uint64_t t = state[1] << 17;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= t;
+            state[3] = rotl(state[3], 45);
+
+            return result;
+        }
+
+        // Unbiased integer in [0, bound), Lemire's multiply and reject
+        uint32_t below(uint32_t bound){
+            if(bound == 0){
+                return 0;
+            }
+
+            uint64_t m = (next() >> 32) * bound;
+            uint32_t low = (uint32_t)m;
+            if(low < bound){
+                uint32_t threshold = -bound % bound;
+                while(low < threshold){
+                    m = (next() >> 32) * bound;
+                    low = (uint32_t)m;
+                }
+            }
+
+            return m >> 32;
+        }
+
+        // Integer in [lo, hi), lo when the range is empty
+        int range(int lo, int hi){
+            return hi > lo ? lo + (int)below(hi - lo) : lo;
+        }
+
+        // Float in [lo, hi) from the top 24 bits
+        float uniform(float lo, float hi){
+            return lo + (hi - lo) * ((next() >> 40) * (1.0f / 16777216.0f));
+        }
+
+    private:
+        static uint64_t rotl(uint64_t x, int k){
+            return (x << k) | (x >> (64 - k));
+        }
+
+        uint64_t state[4];
+};
+}
+
+#endif // SIM_RANDOM_H
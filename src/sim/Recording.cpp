@@ -0,0 +1,317 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Recording.h"
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "EntityStore.h"
+#include "Session.h"
+
+namespace {
+
+const char MAGIC[4] = {'G', 'R', 'E', 'C'};
+// Version 1 had no scattered balls
+const uint8_t VERSION = 2;
+
+void putVarint(std::string& out, uint64_t value){
+    while(value >= 0x80){
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+void putSigned(std::string& out, int64_t value){
+    putVarint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+void putFixed(std::string& out, uint64_t value, int bytes){
+    for(int i = 0; i < bytes; i++){
+        out.push_back((char)(value >> (i * 8)));
+    }
+}
+
+void putFloat(std::string& out, float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putFixed(out, bits, 4);
+}
+
+struct Reader {
+    const std::string& data;
+    size_t offset;
+    bool ok;
+
+    uint64_t varint(){
+        uint64_t value = 0;
+        for(int shift = 0; shift < 64; shift += 7){
+            if(offset >= data.size()){
+                ok = false;
+                return 0;
+            }
+            uint8_t byte = data[offset++];
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            if(!(byte & 0x80)){
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    int64_t svarint(){
+        uint64_t value = varint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    uint64_t fixed(int bytes){
+        if(offset + bytes > data.size()){
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for(int i = 0; i < bytes; i++){
+            value |= (uint64_t)(uint8_t)data[offset++] << (i * 8);
+        }
+        return value;
+    }
+
+    float real(){
+        uint32_t bits = fixed(4);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+void hashBytes(uint64_t& hash, const void* data, size_t size){
+    const uint8_t* bytes = (const uint8_t*)data;
+    for(size_t i = 0; i < size; i++){
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+}
+
+void hashVector(uint64_t& hash, const math::Vector2f& v){
+    hashBytes(hash, &v.x, sizeof(v.x));
+    hashBytes(hash, &v.y, sizeof(v.y));
+}
+}
+
+// Layout: magic, version, seed, dt, width, height, ball/hole/tile scale, tile count, scattered balls, courses, inputs, final tick, final hash.
+// Inputs store the tick as a delta from the previous input
+bool sim::Recording::save(const std::string path) const {
+    std::string out(MAGIC, sizeof(MAGIC));
+    out.push_back((char)VERSION);
+
+    putVarint(out, seed);
+    putFloat(out, dt);
+    putVarint(out, width);
+    putVarint(out, height);
+    putFloat(out, ball_scale.x);
+    putFloat(out, ball_scale.y);
+    putFloat(out, hole_scale.x);
+    putFloat(out, hole_scale.y);
+    putFloat(out, tile_scale.x);
+    putFloat(out, tile_scale.y);
+    putVarint(out, tile_count);
+    putVarint(out, balls);
+
+    putVarint(out, courses.size());
+    for(const std::string& course : courses){
+        putVarint(out, course.size());
+        out += course;
+    }
+
+    putVarint(out, inputs.size());
+    uint32_t tick = 0;
+    for(const Input& input : inputs){
+        putVarint(out, input.tick - tick);
+        tick = input.tick;
+
+        out.push_back((char)input.type);
+        switch(input.type){
+            case InputType::MOUSE_DOWN:
+            case InputType::MOUSE_UP:
+                putSigned(out, input.x);
+                putSigned(out, input.y);
+                break;
+            case InputType::KEY:
+                putSigned(out, input.key);
+                break;
+            case InputType::QUIT:
+                break;
+        }
+    }
+
+    putVarint(out, final_tick);
+    putFixed(out, final_hash, 8);
+
+    std::ofstream file(path, std::ios::binary);
+    if(!file){
+        return false;
+    }
+    file.write(out.data(), out.size());
+    return file.good();
+}
+
+bool sim::Recording::load(const std::string path){
+    std::ifstream file(path, std::ios::binary);
+    if(!file){
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if(data.size() < sizeof(MAGIC) + 1 || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0){
+        return false;
+    }
+
+    uint8_t version = data[sizeof(MAGIC)];
+    if(version < 1 || version > VERSION){
+        return false;
+    }
+
+    Reader in = {data, sizeof(MAGIC) + 1, true};
+    Recording recording;
+
+    recording.seed = in.varint();
+    recording.dt = in.real();
+    recording.width = in.varint();
+    recording.height = in.varint();
+    recording.ball_scale.x = in.real();
+    recording.ball_scale.y = in.real();
+    recording.hole_scale.x = in.real();
+    recording.hole_scale.y = in.real();
+    recording.tile_scale.x = in.real();
+    recording.tile_scale.y = in.real();
+    recording.tile_count = in.varint();
+    if(version >= 2){
+        recording.balls = in.varint();
+    }
+
+    uint64_t course_count = in.varint();
+    for(uint64_t i = 0; i < course_count && in.ok; i++){
+        uint64_t length = in.varint();
+        if(in.offset + length > data.size()){
+            return false;
+        }
+        recording.courses.push_back(data.substr(in.offset, length));
+        in.offset += length;
+    }
+
+    uint64_t input_count = in.varint();
+    uint32_t tick = 0;
+    for(uint64_t i = 0; i < input_count && in.ok; i++){
+        Input input = {0, InputType::QUIT, 0, 0, 0};
+        tick += in.varint();
+        input.tick = tick;
+        input.type = (InputType)in.fixed(1);
+
+        switch(input.type){
+            case InputType::MOUSE_DOWN:
+            case InputType::MOUSE_UP:
+                input.x = in.svarint();
+                input.y = in.svarint();
+                break;
+            case InputType::KEY:
+                input.key = in.svarint();
+                break;
+            case InputType::QUIT:
+                break;
+            default:
+                return false;
+        }
+        recording.inputs.push_back(input);
+    }
+
+    recording.final_tick = in.varint();
+    recording.final_hash = in.fixed(8);
+
+    if(!in.ok || recording.dt <= 0.0f){
+        return false;
+    }
+
+    *this = recording;
+    return true;
+}
+
+bool sim::grabsBall(const World& world, int x, int y){
+    Ball ball = world.getBall();
+    const math::Vector2f& p = ball.getPosition();
+    const math::Vector2f& s = ball.getScale();
+
+    return !ball.isMoving() && x > p.x && x < p.x + s.x && y > p.y && y < p.y + s.y;
+}
+
+math::Vector2f sim::aimFrom(const World& world, int x, int y){
+    Ball ball = world.getBall();
+    const math::Vector2f& p = ball.getPosition();
+    const math::Vector2f& s = ball.getScale();
+
+    return math::Vector2f(-(x - (p.x + s.x / 2)), -(y - (p.y + s.y / 2)));
+}
+
+uint64_t sim::hashWorld(const World& world){
+    uint64_t hash = 0xCBF29CE484222325ull;
+
+    Ball ball = world.getBall();
+    hashVector(hash, ball.getPosition());
+    hashVector(hash, ball.getScale());
+    hashVector(hash, ball.getVelocity());
+
+    uint8_t flags = (ball.isMoving() ? 1 : 0) | (world.hasWon() ? 2 : 0);
+    hashBytes(hash, &flags, sizeof(flags));
+
+    hashVector(hash, world.getHole().getPosition());
+    hashVector(hash, world.getHole().getScale());
+
+    for(const Tile& tile : world.getTiles()){
+        hashVector(hash, tile.getPosition());
+        hashVector(hash, tile.getScale());
+    }
+
+    // Nothing extra without other balls so hashes from before scattering still match
+    const EntityStore& entities = world.getEntities();
+    for(size_t i = 1; i < entities.size(); i++){
+        hashVector(hash, entities.getPosition(i));
+        hashVector(hash, entities.getVelocity(i));
+        uint8_t moving = entities.isMoving(i);
+        hashBytes(hash, &moving, sizeof(moving));
+    }
+
+    return hash;
+}
+
+sim::ReplayResult sim::replay(const Recording& recording){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    Session session(recording);
+
+    auto advance = [&](uint32_t tick){
+        while(session.getTick() < tick){
+            session.step();
+            session.getWorld().clearEvents();
+        }
+    };
+
+    for(const Input& input : recording.inputs){
+        advance(input.tick);
+        session.apply(input);
+        session.getWorld().clearEvents();
+    }
+
+    advance(recording.final_tick);
+
+    ReplayResult result;
+    result.ticks = session.getTick();
+    result.shots = session.getShots();
+    result.hash = hashWorld(session.getWorld());
+    result.matched = result.hash == recording.final_hash;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
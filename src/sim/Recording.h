@@ -0,0 +1,78 @@
+#ifndef SIM_RECORDING_H
+#define SIM_RECORDING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "World.h"
+
+namespace sim {
+
+enum class InputType : uint8_t {
+    MOUSE_DOWN = 1,
+    MOUSE_UP = 2,
+    KEY = 3,
+    QUIT = 4
+};
+
+// tick is the number of physics steps taken before the input was handled
+struct Input {
+    uint32_t tick;
+    InputType type;
+    int32_t x;
+    int32_t y;
+    int32_t key;    // SDL keycode, Session only acts on KEY_RESET
+};
+
+// A played session: the setup App::finishLoading did, every input the game reacted to and the state it ended in.
+// Stored as varints after a small fixed header, a few bytes per input
+struct Recording {
+    uint64_t seed = 0;
+    float dt = 0.016f;
+    int width = 0;
+    int height = 0;
+
+    math::Vector2f ball_scale;
+    math::Vector2f hole_scale;
+    math::Vector2f tile_scale;
+    uint32_t tile_count = 0;
+    uint32_t balls = 0;     // World::setScatter
+
+    std::vector<std::string> courses;
+    std::vector<Input> inputs;
+
+    uint32_t final_tick = 0;
+    uint64_t final_hash = 0;
+
+    bool save(const std::string path) const;
+
+    bool load(const std::string path);
+
+    // SDLK_SPACE, resets once the ball is in
+    static constexpr int32_t KEY_RESET = ' ';
+};
+
+struct ReplayResult {
+    uint32_t ticks;
+    uint64_t hash;
+    int shots;
+    bool matched;
+    double seconds;
+};
+
+// True when a press at (x, y) picks up the ball for aiming
+bool grabsBall(const World& world, int x, int y);
+
+// Shot for a drag released at (x, y), the ball flies away from the cursor
+math::Vector2f aimFrom(const World& world, int x, int y);
+
+// FNV-1a over the bits of everything the simulation can change
+uint64_t hashWorld(const World& world);
+
+// Runs a recording through a fresh Session with nothing drawn, as fast as it steps
+ReplayResult replay(const Recording& recording);
+}
+
+#endif // SIM_RECORDING_H
@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Session.h"
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "Recording.h"
+#include "CourseFile.h"
+#include "Profiler.h"
+
+sim::Session::Session(const Recording& setup)
+: world(setup.width, setup.height, setup.seed), courses(setup.courses), dt(setup.dt) {
+    world.setBallScale(setup.ball_scale.x, setup.ball_scale.y);
+    world.setHoleScale(setup.hole_scale.x, setup.hole_scale.y);
+    for(uint32_t i = 0; i < setup.tile_count; i++){
+        world.addTile(setup.tile_scale.x, setup.tile_scale.y);
+    }
+    world.setScatter(setup.balls);
+
+    if(courses.empty()){
+        world.randomize();
+    }
+    else {
+        loadCourse(0);
+    }
+}
+
+void sim::Session::apply(const Input& input){
+    switch(input.type){
+        case InputType::MOUSE_DOWN:
+            if(grabsBall(world, input.x, input.y)){
+                aiming = true;
+            }
+            break;
+        case InputType::MOUSE_UP:
+            if(aiming && shoot(aimFrom(world, input.x, input.y))){
+                aiming = false;
+            }
+            break;
+        case InputType::KEY:
+            if(input.key == Recording::KEY_RESET && world.hasWon()){
+                nextCourse();
+            }
+            break;
+        case InputType::QUIT:
+            break;
+    }
+}
+
+bool sim::Session::shoot(math::Vector2f aim){
+    if(!world.shoot(aim)){
+        return false;
+    }
+
+    shots++;
+    return true;
+}
+
+void sim::Session::step(){
+    {
+        PROFILE_SCOPE("updatePhysics");
+        world.advance(dt);
+    }
+    {
+        PROFILE_SCOPE("checkCollisions");
+        world.collide();
+    }
+    tick++;
+}
+
+sim::World& sim::Session::getWorld(){
+    return world;
+}
+
+const sim::World& sim::Session::getWorld() const {
+    return world;
+}
+
+uint32_t sim::Session::getTick() const {
+    return tick;
+}
+
+float sim::Session::getDeltaTime() const {
+    return dt;
+}
+
+bool sim::Session::isAiming() const {
+    return aiming;
+}
+
+int sim::Session::getShots() const {
+    return shots;
+}
+
+size_t sim::Session::getCourseIndex() const {
+    return course_index;
+}
+
+uint32_t sim::Session::getCourseVersion() const {
+    return course_version;
+}
+
+void sim::Session::nextCourse(){
+    if(courses.empty()){
+        world.reset();
+    }
+    else {
+        loadCourse((course_index + 1) % courses.size());
+    }
+    course_version++;
+}
+
+void sim::Session::loadCourse(size_t index){
+    course_index = index;
+
+    // A file that fails to open keeps the previous hole, App checks every path before it starts
+    CourseFile file;
+    if(file.open(courses[index])){
+        world.load(file);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SIM_SESSION_H
+#define SIM_SESSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "Recording.h"
+
+namespace sim {
+
+// A World driven by Inputs under the rules of the game, shared by the simulation thread and replays
+// so the two cannot drift apart. Events pile up in the world until the caller clears them
+class Session
+{
+    public:
+        // Builds the world from the header fields of setup, its inputs are not applied
+        Session(const Recording& setup);
+
+        // Acts on an input at the current tick, before the next step
+        void apply(const Input& input);
+
+        // A stroke with aim as World::shoot takes it, false when the ball is still rolling or the aim is too weak or not finite
+        bool shoot(math::Vector2f aim);
+
+        void step();
+
+        World& getWorld();
+        const World& getWorld() const;
+
+        uint32_t getTick() const;
+
+        float getDeltaTime() const;
+
+        // Holding the ball after a press on it, the release shoots
+        bool isAiming() const;
+
+        int getShots() const;
+
+        size_t getCourseIndex() const;
+
+        // Bumped every time a new hole starts, the hole and tiles only change with it
+        uint32_t getCourseVersion() const;
+
+    private:
+        void nextCourse();
+
+        void loadCourse(size_t index);
+
+        World world;
+        std::vector<std::string> courses;
+        float dt;
+
+        uint32_t tick = 0;
+        bool aiming = false;
+        int shots = 0;
+
+        size_t course_index = 0;
+        uint32_t course_version = 1;
+};
+}
+
+#endif // SIM_SESSION_H
@@ -0,0 +1,174 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Simulation.h"
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "EntityStore.h"
+#include "Session.h"
+#include "Profiler.h"
+
+sim::Simulation::Simulation(const Recording& setup, const std::string recording_path)
+: session(setup), recording(setup), recording_path(recording_path),
+  tick_length(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(setup.dt))) {
+    previous = session.getWorld().getEntities();
+}
+
+sim::Simulation::~Simulation(){
+    stop();
+}
+
+void sim::Simulation::start(){
+    if(running){
+        return;
+    }
+
+    // Something to draw before the first tick
+    publish(std::chrono::steady_clock::now());
+
+    running = true;
+    thread = std::thread(&Simulation::run, this);
+}
+
+void sim::Simulation::stop(){
+    running = false;
+    if(thread.joinable()){
+        thread.join();
+    }
+
+    // The consumer thread is gone, so this one may take its place
+    drainInputs();
+}
+
+bool sim::Simulation::post(const Input& input){
+    return input_queue.push(input);
+}
+
+bool sim::Simulation::pollEvent(Event& event){
+    return event_queue.pop(event);
+}
+
+const sim::Snapshot& sim::Simulation::latest(){
+    return snapshots.read();
+}
+
+const sim::Session& sim::Simulation::getSession() const {
+    return session;
+}
+
+bool sim::Simulation::saveRecording(){
+    return !recording_path.empty() && flush();
+}
+
+void sim::Simulation::run(){
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now() + tick_length;
+
+    while(running){
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        int substeps = 0;
+        while(next <= now && substeps < MAX_CATCH_UP){
+            PROFILE_SCOPE("tick");
+            tick();
+            publish(next);
+            next += tick_length;
+            substeps++;
+        }
+        PROFILE_COUNT("substeps", substeps);
+
+        // A few bytes per input, nothing to write while nobody plays
+        if(!recording_path.empty() && recording.inputs.size() > flushed_inputs && session.getTick() - flushed_tick >= FLUSH_TICKS){
+            flush();
+        }
+
+        if(next <= now){
+            next = now + tick_length;
+        }
+
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void sim::Simulation::drainInputs(){
+    Input input;
+    while(input_queue.pop(input)){
+        // Stamped here, the tick it really lands on, so a replay applies it at the same point
+        input.tick = session.getTick();
+        session.apply(input);
+
+        if(!recording_path.empty()){
+            recording.inputs.push_back(input);
+        }
+    }
+}
+
+void sim::Simulation::tick(){
+    drainInputs();
+
+    World& world = session.getWorld();
+    previous = world.getEntities();
+
+    session.step();
+
+    // A full queue only costs a sound
+    for(const Event& event : world.getEvents()){
+        event_queue.push(event);
+    }
+    world.clearEvents();
+}
+
+bool sim::Simulation::flush(){
+    recording.final_tick = session.getTick();
+    recording.final_hash = hashWorld(session.getWorld());
+    flushed_inputs = recording.inputs.size();
+    flushed_tick = recording.final_tick;
+
+    std::string temporary = recording_path + ".tmp";
+    return recording.save(temporary) && std::rename(temporary.c_str(), recording_path.c_str()) == 0;
+}
+
+void sim::Simulation::publish(std::chrono::steady_clock::time_point due){
+    const World& world = session.getWorld();
+    Snapshot& snapshot = snapshots.back();
+
+    snapshot.tick = session.getTick();
+    snapshot.time = due;
+
+    if(snapshot.course_version != session.getCourseVersion()){
+        snapshot.course_version = session.getCourseVersion();
+        snapshot.course_index = session.getCourseIndex();
+        snapshot.hole = world.getHole();
+        snapshot.tiles.assign(world.getTiles().begin(), world.getTiles().end());
+    }
+
+    const EntityStore& entities = world.getEntities();
+    snapshot.entities = entities;
+
+    // Matched by id, a ball dropped in the hole shifts the rest down a place but they still blend from where they were
+    snapshot.previous_position.resize(entities.size());
+    snapshot.previous_extent.resize(entities.size());
+    for(size_t i = 0; i < entities.size(); i++){
+        uint32_t id = entities.getId(i);
+        if(previous.contains(id)){
+            size_t before = previous.index(id);
+            snapshot.previous_position[i] = previous.getPosition(before);
+            snapshot.previous_extent[i] = previous.extent[before];
+        }
+        else {
+            snapshot.previous_position[i] = entities.getPosition(i);
+            snapshot.previous_extent[i] = entities.extent[i];
+        }
+    }
+
+    snapshot.aiming = session.isAiming();
+    snapshot.moving = world.isMoving();
+    snapshot.won = world.hasWon();
+
+    snapshots.publish();
+}
@@ -0,0 +1,119 @@
+#ifndef SIM_SIMULATION_H
+#define SIM_SIMULATION_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Vector2f.h"
+#include "Body.h"
+#include "EntityStore.h"
+#include "Tile.h"
+#include "Event.h"
+#include "Recording.h"
+#include "Session.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+namespace sim {
+
+// Everything the renderer needs from one tick, never written again once published
+struct Snapshot {
+    uint32_t tick = 0;
+
+    // When this tick was due, the renderer blends from the previous state towards it over one tick
+    std::chrono::steady_clock::time_point time;
+
+    // Session::getCourseVersion, the hole and tiles are only copied when it changes
+    uint32_t course_version = 0;
+    size_t course_index = 0;
+
+    // Every ball, the player's at index 0. previous_position and previous_extent are where each of them
+    // was the tick before, by the same index
+    EntityStore entities;
+    std::vector<math::Vector2f> previous_position, previous_extent;
+
+    Body hole;
+    std::vector<Tile> tiles;
+
+    bool aiming = false;
+    bool moving = false;
+    bool won = false;
+};
+
+// Runs a Session at its fixed tick rate on a thread of its own. Inputs go in through one queue, events
+// come back through another and the newest tick is always readable as a snapshot, neither side waits
+class Simulation
+{
+    public:
+        // With a recording_path every applied input is kept, tick stamped, and the recording is rewritten there
+        // every FLUSH_TICKS while inputs come in, so a crash loses a few seconds of play at most
+        Simulation(const Recording& setup, const std::string recording_path = "");
+
+        ~Simulation();
+
+        void start();
+
+        // Joins the thread and applies whatever input was still queued, safe to call twice
+        void stop();
+
+        // Render thread only, false when the queue is full and the input was dropped
+        bool post(const Input& input);
+
+        // Render thread only
+        bool pollEvent(Event& event);
+
+        // Render thread only, stays valid until the next call
+        const Snapshot& latest();
+
+        // Only while stopped
+        const Session& getSession() const;
+
+        // Only while stopped, writes the recording up to the current tick
+        bool saveRecording();
+
+        // Most ticks caught up at once, time past that after a stall is dropped
+        static constexpr int MAX_CATCH_UP = 8;
+
+        static constexpr size_t INPUT_CAPACITY = 256;
+        static constexpr size_t EVENT_CAPACITY = 1024;
+
+        // About four seconds at the default tick rate
+        static constexpr uint32_t FLUSH_TICKS = 250;
+
+    private:
+        void run();
+
+        void drainInputs();
+
+        void tick();
+
+        void publish(std::chrono::steady_clock::time_point due);
+
+        // Writes beside the file and renames over it, a crash halfway leaves the last flush intact
+        bool flush();
+
+        Session session;
+        Recording recording;
+        std::string recording_path;
+        size_t flushed_inputs = 0;
+        uint32_t flushed_tick = 0;
+
+        SpscQueue<Input, INPUT_CAPACITY> input_queue;
+        SpscQueue<Event, EVENT_CAPACITY> event_queue;
+        TripleBuffer<Snapshot> snapshots;
+
+        // Simulation thread state for filling previous_* in the snapshots, the balls as they were before the last tick
+        EntityStore previous;
+
+        std::chrono::steady_clock::duration tick_length;
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+};
+}
+
+#endif // SIM_SIMULATION_H
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include "Solver.h"
+
+#include "../Vector2f.h"
+#include "World.h"
+#include "Course.h"
+#include "ThreadPool.h"
+
+namespace {
+
+int playShot(sim::World& world, const sim::Course& course, math::Vector2f aim, const sim::SolverOptions& options){
+    world.load(course);
+    if(!world.shoot(aim)){
+        return -1;
+    }
+
+    world.setMotionMode(options.mode);
+    world.setCollisionMode(options.collisions);
+    world.setBroadphase(options.broadphase);
+    int ticks = world.settle(options.dt, options.max_ticks);
+    world.clearEvents();
+
+    return world.hasWon() ? ticks : -1;
+}
+
+math::Vector2f aimFor(float angle, float power){
+    return math::Vector2f(cos(angle) * power, sin(angle) * power);
+}
+
+}
+
+sim::Solver::Solver(ThreadPool& pool, SolverOptions options)
+: pool(pool), options(options) {}
+
+std::vector<sim::Shot> sim::Solver::solve(const Course& course){
+    std::vector<Shot> shots;
+    std::mutex shots_mutex;
+
+    // World::shoot rejects anything at or below half the ball width
+    float min_power = course.ball_scale.x / 2.0f;
+    float power_step = (World::MAX_POWER - min_power) / options.power_steps;
+    float angle_step = 2.0f * M_PI / options.angle_steps;
+
+    shot_count = (size_t)options.angle_steps * options.power_steps;
+
+    pool.parallelFor(options.angle_steps, 4, [&](size_t begin, size_t end){
+        World world;
+        std::vector<Shot> found;
+
+        for(size_t a = begin; a < end; a++){
+            float angle = a * angle_step;
+            for(int p = 1; p <= options.power_steps; p++){
+                float power = min_power + p * power_step;
+                math::Vector2f aim = aimFor(angle, power);
+
+                int ticks = playShot(world, course, aim, options);
+                if(ticks >= 0){
+                    found.push_back({angle, power, aim, ticks});
+                }
+            }
+        }
+
+        if(!found.empty()){
+            std::lock_guard<std::mutex> guard(shots_mutex);
+            shots.insert(shots.end(), found.begin(), found.end());
+        }
+    });
+
+    std::sort(shots.begin(), shots.end(), [](const Shot& a, const Shot& b){
+        return a.angle < b.angle || (a.angle == b.angle && a.power < b.power);
+    });
+
+    return shots;
+}
+
+int sim::Solver::simulate(const Course& course, math::Vector2f aim, const SolverOptions& options){
+    World world;
+    return playShot(world, course, aim, options);
+}
+
+size_t sim::Solver::getShotCount() const {
+    return shot_count;
+}
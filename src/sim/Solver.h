@@ -0,0 +1,50 @@
+#ifndef SIM_SOLVER_H
+#define SIM_SOLVER_H
+
+#include <vector>
+
+#include "../Vector2f.h"
+#include "Course.h"
+#include "World.h"
+#include "ThreadPool.h"
+
+namespace sim {
+
+struct SolverOptions {
+    int angle_steps = 720;
+    int power_steps = 100;
+    float dt = 0.016f;
+    int max_ticks = 5000;
+    MotionMode mode = MotionMode::STEPPED;
+    CollisionMode collisions = CollisionMode::SWEPT;
+    Broadphase broadphase = Broadphase::SORT_AND_SWEEP;
+};
+
+struct Shot {
+    float angle;    // radians, direction the ball travels
+    float power;    // drag length before World::POWER_SCALE, capped at World::MAX_POWER
+    math::Vector2f aim;
+    int ticks;      // fixed steps until the ball dropped in
+};
+
+// Brute force search of every (angle, power) pair World::shoot accepts, returns the shots that end in the hole
+class Solver
+{
+    public:
+        Solver(ThreadPool& pool, SolverOptions options = SolverOptions());
+
+        std::vector<Shot> solve(const Course& course);
+
+        // Simulates one shot from the start of the course, returns the ticks until the hole or -1 on a miss
+        static int simulate(const Course& course, math::Vector2f aim, const SolverOptions& options);
+
+        size_t getShotCount() const;
+
+    private:
+        ThreadPool& pool;
+        SolverOptions options;
+        size_t shot_count = 0;
+};
+}
+
+#endif // SIM_SOLVER_H
@@ -0,0 +1,64 @@
+#ifndef SIM_SPSCQUEUE_H
+#define SIM_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+namespace sim {
+
+// Bounded ring for exactly one producer thread and one consumer thread, no locks and no allocation.
+// Each side caches the other's index and only reloads it when the ring looks full or empty
+template<typename T, size_t N>
+class SpscQueue
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+    public:
+        // Producer only, false when full
+        bool push(const T& value){
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            if(tail - head_cache == N){
+                head_cache = head.load(std::memory_order_acquire);
+                if(tail - head_cache == N){
+                    return false;
+                }
+            }
+
+            items[tail & (N - 1)] = value;
+            this->tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only, false when empty
+        bool pop(T& value){
+            size_t head = this->head.load(std::memory_order_relaxed);
+            if(head == tail_cache){
+                tail_cache = tail.load(std::memory_order_acquire);
+                if(head == tail_cache){
+                    return false;
+                }
+            }
+
+            value = items[head & (N - 1)];
+            this->head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        static constexpr size_t capacity(){
+            return N;
+        }
+
+    private:
+        T items[N];
+
+        // Consumer side
+        alignas(64) std::atomic<size_t> head{0};
+        size_t tail_cache = 0;
+
+        // Producer side
+        alignas(64) std::atomic<size_t> tail{0};
+        size_t head_cache = 0;
+};
+}
+
+#endif // SIM_SPSCQUEUE_H
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <thread>
+
+#include "ThreadPool.h"
+
+namespace {
+thread_local int worker_index = -1;
+thread_local const sim::ThreadPool* worker_pool = nullptr;
+}
+
+sim::ThreadPool::ThreadPool(unsigned int threads)
+: queued(0), pending(0), next(0) {
+    if(threads == 0){
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for(unsigned int i = 0; i < threads; i++){
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    for(unsigned int i = 0; i < threads; i++){
+        this->threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+sim::ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    work_cv.notify_all();
+
+    for(std::thread& thread : threads){
+        thread.join();
+    }
+}
+
+void sim::ThreadPool::submit(std::function<void()> task){
+    unsigned int index;
+    if(worker_pool == this){
+        index = worker_index;
+    }
+    else {
+        index = next.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    }
+
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        queued.fetch_add(1);
+    }
+    {
+        std::lock_guard<std::mutex> guard(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    work_cv.notify_one();
+}
+
+void sim::ThreadPool::wait(){
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]{ return pending.load() == 0; });
+}
+
+void sim::ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body){
+    if(grain == 0){
+        grain = 1;
+    }
+
+    for(size_t begin = 0; begin < count; begin += grain){
+        size_t end = std::min(count, begin + grain);
+        submit([&body, begin, end]{ body(begin, end); });
+    }
+
+    wait();
+}
+
+unsigned int sim::ThreadPool::size() const {
+    return threads.size();
+}
+
+void sim::ThreadPool::work(unsigned int index){
+    worker_index = index;
+    worker_pool = this;
+
+    std::function<void()> task;
+    while(true){
+        if(pop(index, task)){
+            task();
+            task = nullptr;
+
+            if(pending.fetch_sub(1) == 1){
+                std::lock_guard<std::mutex> guard(mutex);
+                done_cv.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        work_cv.wait(lock, [this]{ return stopping || queued.load() > 0; });
+        if(stopping && queued.load() == 0){
+            return;
+        }
+    }
+}
+
+bool sim::ThreadPool::pop(unsigned int index, std::function<void()>& task){
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> guard(own.mutex);
+        if(!own.tasks.empty()){
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for(size_t i = 1; i < queues.size(); i++){
+        Queue& victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.mutex);
+        if(!victim.tasks.empty()){
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
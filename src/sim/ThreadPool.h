@@ -0,0 +1,58 @@
+#ifndef SIM_THREADPOOL_H
+#define SIM_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+// Work stealing pool: every worker owns a deque, pops its own tasks from the back
+// and steals from the front of the other deques when it runs dry
+class ThreadPool
+{
+    public:
+        ThreadPool(unsigned int threads = 0);
+
+        ~ThreadPool();
+
+        void submit(std::function<void()> task);
+
+        // Must not be called from inside a task
+        void wait();
+
+        // Splits [0, count) into chunks of grain and runs body(begin, end) on the pool, then waits
+        void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+        unsigned int size() const;
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void work(unsigned int index);
+
+        bool pop(unsigned int index, std::function<void()>& task);
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+        std::condition_variable work_cv;
+        std::condition_variable done_cv;
+
+        std::atomic<size_t> queued;
+        std::atomic<size_t> pending;
+        std::atomic<unsigned int> next;
+        bool stopping = false;
+};
+}
+
+#endif // SIM_THREADPOOL_H
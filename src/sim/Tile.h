@@ -0,0 +1,16 @@
+#ifndef SIM_TILE_H
+#define SIM_TILE_H
+
+#include "Body.h"
+
+namespace sim {
+
+class Tile : public Body {
+    public:
+        Tile() : Body() {}
+
+        Tile(math::Vector2f position, math::Vector2f scale) : Body(position, scale) {}
+};
+}
+
+#endif // SIM_TILE_H
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Trajectory.h"
+
+#include "../Vector2f.h"
+#include "Ball.h"
+#include "Body.h"
+
+namespace {
+
+// Open interval of travel during which p0 + v * travel lies strictly inside (lo, hi)
+bool slab(double p0, double v, double lo, double hi, double& enter, double& exit){
+    if(v == 0.0){
+        if(p0 > lo && p0 < hi){
+            enter = -INFINITY;
+            exit = INFINITY;
+            return true;
+        }
+        return false;
+    }
+
+    double a = (lo - p0) / v;
+    double b = (hi - p0) / v;
+    enter = std::min(a, b);
+    exit = std::max(a, b);
+    return true;
+}
+
+}
+
+sim::Trajectory::Trajectory(const Ball& ball, float dt)
+: x(ball.getPosition().x), y(ball.getPosition().y), w(ball.getScale().x), h(ball.getScale().y),
+  vx(ball.getVelocity().x), vy(ball.getVelocity().y), dt(dt) {
+    // Same float factor Ball::update multiplies by every tick
+    slow = ball.getVelocity1D() < 10.0f;
+    decay = std::pow(Ball::friction, dt) * (slow ? Ball::slowDecay(dt) : 1.0f);
+}
+
+math::Vector2f sim::Trajectory::positionAt(int ticks) const {
+    double travel = travelAt(ticks);
+    return math::Vector2f(x + vx * travel, y + vy * travel);
+}
+
+math::Vector2f sim::Trajectory::velocityAt(int ticks) const {
+    double factor = std::pow(decay, ticks);
+    return math::Vector2f(vx * factor, vy * factor);
+}
+
+double sim::Trajectory::travelAt(int ticks) const {
+    return dt * decay * (1.0 - std::pow(decay, ticks)) / (1.0 - decay);
+}
+
+int sim::Trajectory::ticksUntilTravel(double travel) const {
+    if(travel <= 0.0){
+        return 1;
+    }
+
+    double remaining = 1.0 - travel * (1.0 - decay) / (dt * decay);
+    if(remaining <= 0.0){
+        return NEVER;
+    }
+
+    double ticks = std::ceil(std::log(remaining) / std::log(decay));
+    return ticks < 1.0 ? 1 : ticks >= NEVER ? NEVER : (int)ticks;
+}
+
+int sim::Trajectory::ticksUntilSpeed(float speed) const {
+    double current = std::sqrt(vx * vx + vy * vy) / 10.0;
+    if(current < speed){
+        return 1;
+    }
+
+    double ticks = std::floor(std::log(speed / current) / std::log(decay)) + 1.0;
+    return ticks >= NEVER ? NEVER : (int)ticks;
+}
+
+int sim::Trajectory::ticksUntilRegimeChange() const {
+    return slow ? NEVER : ticksUntilSpeed(10.0f);
+}
+
+int sim::Trajectory::ticksUntilDeadZone() const {
+    int ticks = NEVER;
+    for(double v : {vx, vy}){
+        if(v == 0.0){
+            continue;
+        }
+
+        double speed = std::abs(v);
+        if(speed < 0.5){
+            return 1;
+        }
+        ticks = std::min(ticks, (int)(std::floor(std::log(0.5 / speed) / std::log(decay)) + 1.0));
+    }
+
+    return ticks;
+}
+
+int sim::Trajectory::ticksUntilWall(int width, int height) const {
+    int ticks = NEVER;
+
+    if(vx < 0.0){
+        ticks = std::min(ticks, ticksUntilTravel(x / -vx));
+    }
+    else if(vx > 0.0){
+        ticks = std::min(ticks, ticksUntilTravel((width - w - x) / vx));
+    }
+
+    if(vy < 0.0){
+        ticks = std::min(ticks, ticksUntilTravel(y / -vy));
+    }
+    else if(vy > 0.0){
+        ticks = std::min(ticks, ticksUntilTravel((height - h - y) / vy));
+    }
+
+    return ticks;
+}
+
+int sim::Trajectory::ticksUntilOverlap(const Body& body) const {
+    double enter_x, exit_x, enter_y, exit_y;
+    if(!slab(x, vx, body.getPosition().x - w, body.getPosition().x + body.getScale().x, enter_x, exit_x) ||
+       !slab(y, vy, body.getPosition().y - h, body.getPosition().y + body.getScale().y, enter_y, exit_y)){
+        return NEVER;
+    }
+
+    double enter = std::max(enter_x, enter_y);
+    double exit = std::min(exit_x, exit_y);
+    if(enter >= exit || exit <= 0.0){
+        return NEVER;
+    }
+
+    return ticksUntilTravel(enter);
+}
+
+int sim::Trajectory::ticksUntilHole(const Body& hole, float radius, float max_speed) const {
+    double px = x + w / 2.0 - (hole.getPosition().x + hole.getScale().x / 2.0);
+    double py = y + h / 2.0 - (hole.getPosition().y + hole.getScale().y / 2.0);
+
+    // |p + v * travel| < radius
+    double a = vx * vx + vy * vy;
+    double b = 2.0 * (px * vx + py * vy);
+    double c = px * px + py * py - (double)radius * radius;
+    double disc = b * b - 4.0 * a * c;
+    if(a == 0.0 || disc < 0.0){
+        return NEVER;
+    }
+
+    double root = std::sqrt(disc);
+    double enter = (-b - root) / (2.0 * a);
+    double exit = (-b + root) / (2.0 * a);
+    if(exit <= 0.0){
+        return NEVER;
+    }
+
+    int ticks = std::max(ticksUntilTravel(enter), ticksUntilSpeed(max_speed));
+    if(ticks == NEVER || travelAt(ticks - 1) >= exit){
+        return NEVER;
+    }
+
+    return ticks;
+}
@@ -0,0 +1,53 @@
+#ifndef SIM_TRAJECTORY_H
+#define SIM_TRAJECTORY_H
+
+#include <climits>
+
+#include "../Vector2f.h"
+#include "Ball.h"
+#include "Body.h"
+
+namespace sim {
+
+// Closed form of Ball::update while the friction factor stays the same:
+// after n ticks v = v0 * d^n and the ball has travelled v0 * dt * d * (1 - d^n) / (1 - d)
+// All the ticksUntil queries return the first tick (from 1) at which the event can happen
+class Trajectory
+{
+    public:
+        Trajectory(const Ball& ball, float dt);
+
+        math::Vector2f positionAt(int ticks) const;
+
+        math::Vector2f velocityAt(int ticks) const;
+
+        // Travel is measured as a multiple of the current velocity, position = p0 + v0 * travel
+        double travelAt(int ticks) const;
+
+        int ticksUntilTravel(double travel) const;
+
+        int ticksUntilSpeed(float speed) const;
+
+        int ticksUntilRegimeChange() const;
+
+        int ticksUntilDeadZone() const;
+
+        int ticksUntilWall(int width, int height) const;
+
+        int ticksUntilOverlap(const Body& body) const;
+
+        int ticksUntilHole(const Body& hole, float radius, float max_speed) const;
+
+        static constexpr int NEVER = INT_MAX;
+
+    private:
+        double x, y;
+        double w, h;
+        double vx, vy;
+        double dt;
+        double decay;
+        bool slow;
+};
+}
+
+#endif // SIM_TRAJECTORY_H
@@ -0,0 +1,48 @@
+#ifndef SIM_TRIPLEBUFFER_H
+#define SIM_TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace sim {
+
+// One writer and one reader pass whole values without ever waiting on each other. The writer fills
+// its back buffer and swaps it with the middle one, the reader swaps the middle one for its front
+// buffer whenever something newer is there. Values in between are skipped, the reader always gets the newest
+template<typename T>
+class TripleBuffer
+{
+    public:
+        // Writer only, the buffer to fill before publish()
+        T& back(){
+            return buffers[back_index];
+        }
+
+        // Writer only
+        void publish(){
+            back_index = middle.exchange(back_index | FRESH, std::memory_order_acq_rel) & INDEX;
+        }
+
+        // Reader only, the newest published value, the same as last time when nothing new came in
+        const T& read(){
+            if(middle.load(std::memory_order_relaxed) & FRESH){
+                front_index = middle.exchange(front_index, std::memory_order_acq_rel) & INDEX;
+            }
+            return buffers[front_index];
+        }
+
+    private:
+        static constexpr uint8_t INDEX = 3;
+        static constexpr uint8_t FRESH = 4;
+
+        T buffers[3];
+
+        alignas(64) std::atomic<uint8_t> middle{1};
+
+        alignas(64) uint8_t back_index = 0;     // writer side
+
+        alignas(64) uint8_t front_index = 2;    // reader side
+};
+}
+
+#endif // SIM_TRIPLEBUFFER_H
@@ -0,0 +1,769 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "World.h"
+
+#include "../Vector2f.h"
+#include "Ball.h"
+#include "EntityStore.h"
+#include "Tile.h"
+#include "Event.h"
+#include "Course.h"
+#include "Trajectory.h"
+#include "CourseFile.h"
+#include "Generator.h"
+#include "Profiler.h"
+
+sim::World::World() : width(0), height(0) {
+    entities.create(Ball());
+}
+
+sim::World::World(int width, int height, uint64_t seed)
+: width(width), height(height), random(seed) {
+    entities.create(Ball());
+}
+
+void sim::World::step(float dt){
+    advance(dt);
+    collide();
+}
+
+void sim::World::advance(float dt){
+    if(grid_stale){
+        rebuildBroadphase();
+    }
+    step_dt = dt;
+
+    // Balls at rest sit the tick out, collide() needs to know which ones they were
+    starts.resize(entities.size());
+    rolling.resize(entities.size());
+    for(size_t i = 0; i < entities.size(); i++){
+        rolling[i] = entities.isMoving(i);
+        starts[i] = entities.getPosition(i);
+    }
+
+    // Every ball moves in place in the store, bit for bit what Ball::update gives them one by one
+    entities.integrate(dt);
+}
+
+void sim::World::collide(){
+    if(collisions == CollisionMode::SWEPT){
+        sweep(0, starts[0]);
+    }
+    else {
+        checkWalls(0);
+    }
+
+    if(!win){
+        checkHole();
+    }
+    else {
+        shrink(0, 0.5f * (step_dt / Ball::reference_dt));
+    }
+
+    if(collisions == CollisionMode::DISCRETE && entities.isMoving(0)){
+        checkCollisions(0);
+    }
+
+    if(entities.size() > 1){
+        collideOthers();
+    }
+}
+
+int sim::World::settle(float dt, int max_ticks){
+    int ticks = 0;
+    while(isMoving() && ticks < max_ticks){
+        // Trajectory only knows the player ball, other balls step every tick
+        if(mode == MotionMode::EVENT_DRIVEN && entities.size() == 1){
+            // Land two ticks short of the event and let step() resolve it with the real rules
+            int next = std::min(nextEventTick(dt), max_ticks - ticks + 2);
+            if(next > 2){
+                jump(dt, next - 2);
+                ticks += next - 2;
+                continue;
+            }
+        }
+
+        step(dt);
+        ticks++;
+    }
+
+    return ticks;
+}
+
+int sim::World::nextEventTick(float dt) const {
+    Ball ball = entities.getBall(0);
+    Trajectory path(ball, dt);
+
+    int ticks = std::min(path.ticksUntilRegimeChange(), path.ticksUntilDeadZone());
+    ticks = std::min(ticks, path.ticksUntilWall(width, height));
+
+    // Look for tiles a few grid cells ahead at most, a closer horizon only costs an extra evaluation
+    float speed = ball.getVelocity().magnitude();
+    if(speed > 0.0f){
+        ticks = std::min(ticks, path.ticksUntilTravel(EVENT_HORIZON * grid.getCellSize() / speed));
+    }
+
+    // Only tiles along the path up to the earliest event so far can come first
+    math::Vector2f from = ball.getPosition();
+    math::Vector2f to = path.positionAt(ticks);
+    const std::vector<int>& nearby = nearbyTiles(std::min(from.x, to.x), std::min(from.y, to.y),
+                                                 std::max(from.x, to.x) + ball.getScale().x, std::max(from.y, to.y) + ball.getScale().y);
+    for(int i : nearby){
+        ticks = std::min(ticks, path.ticksUntilOverlap(tiles[i]));
+    }
+
+    if(!win){
+        ticks = std::min(ticks, path.ticksUntilHole(hole, HOLE_RADIUS, HOLE_MAX_SPEED));
+    }
+
+    return ticks;
+}
+
+void sim::World::jump(float dt, int ticks){
+    Ball ball = entities.getBall(0);
+    Trajectory path(ball, dt);
+
+    ball.setPosition(path.positionAt(ticks));
+    ball.setVelocity(path.velocityAt(ticks));
+    ball.setVelocity1D((ball.getVelocity() / 10).magnitude());
+    entities.setBall(0, ball);
+}
+
+void sim::World::setMotionMode(MotionMode mode){
+    this->mode = mode;
+}
+
+sim::MotionMode sim::World::getMotionMode() const {
+    return mode;
+}
+
+void sim::World::setCollisionMode(CollisionMode collisions){
+    this->collisions = collisions;
+}
+
+sim::CollisionMode sim::World::getCollisionMode() const {
+    return collisions;
+}
+
+void sim::World::setBroadphase(Broadphase broadphase){
+    this->broadphase = broadphase;
+}
+
+sim::Broadphase sim::World::getBroadphase() const {
+    return broadphase;
+}
+
+void sim::World::rebuildBroadphase(){
+    grid.build(tiles, width, height);
+    grid_stale = false;
+
+    // Cells are at least as large as any tile, so a tile shows up in at most four of them and
+    // a query never returns more than this before duplicates are removed
+    candidates.reserve(tiles.size() * 4);
+}
+
+bool sim::World::shoot(math::Vector2f aim){
+    Ball ball = entities.getBall(0);
+
+    // Every comparison below is false for NaN, such an aim would set the ball moving for good
+    if(ball.isMoving() || !std::isfinite(aim.x) || !std::isfinite(aim.y)){
+        return false;
+    }
+
+    ball.setVelocity1D(aim.magnitude());
+
+    if(ball.getVelocity1D() <= ball.getScale().x / 2.0f){
+        return false;
+    }
+
+    if(ball.getVelocity1D() > MAX_POWER){
+        ball.setVelocity1D(MAX_POWER);
+        float angle = atan2(aim.y, aim.x);
+        aim.x = cos(angle) * ball.getVelocity1D();
+        aim.y = sin(angle) * ball.getVelocity1D();
+    }
+
+    aim *= POWER_SCALE;
+
+    ball.setVelocity(aim);
+    ball.setMoving(true);
+    entities.setBall(0, ball);
+
+    emit(EventType::SWING, 0);
+
+    return true;
+}
+
+void sim::World::reset(){
+    entities.extent[0] = ball_scale;
+    randomize();
+
+    win = false;
+}
+
+void sim::World::randomize(){
+    // Always from the full set, a reset that could not fit every tile must not lose them for good.
+    // layout and tiles trade buffers every reset, after the first two nothing here allocates
+    layout.width = width;
+    layout.height = height;
+    layout.ball_scale = ball_scale;
+    layout.hole_scale = hole.getScale();
+    layout.tiles.assign(tile_set.begin(), tile_set.end());
+    CourseGenerator().place(layout, random, cells);
+
+    entities.setPosition(0, layout.ball_position);
+    hole.setPosition(layout.hole_position);
+    tiles.swap(layout.tiles);
+
+    rebuildBroadphase();
+    placeBalls();
+}
+
+void sim::World::load(const Course& course){
+    width = course.width;
+    height = course.height;
+
+    ball_scale = course.ball_scale;
+    entities.setBall(0, Ball(course.ball_position, course.ball_scale));
+
+    hole.setScale(course.hole_scale);
+    hole.setPosition(course.hole_position);
+
+    tiles.assign(course.tiles.begin(), course.tiles.end());
+    tile_set = tiles;
+    rebuildBroadphase();
+    placeBalls();
+
+    events.clear();
+    win = false;
+}
+
+void sim::World::load(const CourseFile& file){
+    const CourseHeader& header = file.getHeader();
+
+    width = header.width;
+    height = header.height;
+
+    ball_scale = math::Vector2f(header.ball[2], header.ball[3]);
+    entities.setBall(0, Ball(math::Vector2f(header.ball[0], header.ball[1]), ball_scale));
+
+    hole.setScale(header.hole[2], header.hole[3]);
+    hole.setPosition(header.hole[0], header.hole[1]);
+
+    // Straight copy out of the mapping, reuses the capacity of the previous course
+    tiles.assign(file.getTiles(), file.getTiles() + file.getTileCount());
+    tile_set = tiles;
+    rebuildBroadphase();
+    placeBalls();
+
+    events.clear();
+    win = false;
+}
+
+sim::Course sim::World::getCourse() const {
+    Course course;
+    course.width = width;
+    course.height = height;
+    course.ball_position = entities.getPosition(0);
+    course.ball_scale = ball_scale;
+    course.hole_position = hole.getPosition();
+    course.hole_scale = hole.getScale();
+    course.tiles = tiles;
+
+    return course;
+}
+
+void sim::World::checkWalls(size_t ball){
+    std::vector<float>& x = entities.motion.x;
+    std::vector<float>& y = entities.motion.y;
+    const math::Vector2f& extent = entities.extent[ball];
+
+    if(x[ball] < 0){
+        x[ball] = 0.0f;
+        entities.motion.vx[ball] = -entities.motion.vx[ball];
+        emit(EventType::WALL_COLLISION, ball);
+    }
+    else if(x[ball] + extent.x > width){
+        x[ball] = width - extent.x;
+        entities.motion.vx[ball] = -entities.motion.vx[ball];
+        emit(EventType::WALL_COLLISION, ball);
+    }
+
+    if(y[ball] < 0){
+        y[ball] = 0.0f;
+        entities.motion.vy[ball] = -entities.motion.vy[ball];
+        emit(EventType::WALL_COLLISION, ball);
+    }
+    else if(y[ball] + extent.y > height){
+        y[ball] = height - extent.y;
+        entities.motion.vy[ball] = -entities.motion.vy[ball];
+        emit(EventType::WALL_COLLISION, ball);
+    }
+}
+
+void sim::World::checkHole(){
+    if(captures(0)){
+        entities.setVelocity(0, math::Vector2f(0.0f, 0.0f));
+        entities.motion.moving[0] = 0;
+        win = true;
+        emit(EventType::HOLE_IN, 0);
+    }
+}
+
+bool sim::World::captures(size_t ball) const {
+    math::Vector2f center = entities.getBody(ball).getCenter();
+    float distance = sqrt(pow(center.x - hole.getCenter().x, 2) + pow(center.y - hole.getCenter().y, 2));
+    return distance < HOLE_RADIUS && entities.motion.speed[ball] < HOLE_MAX_SPEED;
+}
+
+void sim::World::checkCollisions(size_t ball){
+    Body body = entities.getBody(ball);
+    const math::Vector2f& p = body.getPosition();
+    const std::vector<int>& nearby = nearbyTiles(p.x, p.y, p.x + body.getScale().x, p.y + body.getScale().y);
+    for(int i : nearby){
+        const Tile& t = tiles[i];
+        sim::Direction dir = body.collidesWith(t);
+        if(dir != sim::Direction::NONE){
+            bounce(ball, t, dir);
+            emit(EventType::TILE_COLLISION, ball);
+
+            break;
+        }
+    }
+}
+
+void sim::World::sweep(size_t ball, math::Vector2f from){
+    PROFILE_SCOPE("sweep");
+
+    math::Vector2f displacement = entities.getPosition(ball) - from;
+    entities.setPosition(ball, from);
+
+    // Walls are bodies just outside the field so they go through the same time of impact query
+    const float thickness = 1000000.0f;
+    const Body walls[4] = {
+        Body(math::Vector2f(-thickness, -thickness), math::Vector2f(thickness, height + 2 * thickness)),
+        Body(math::Vector2f(width, -thickness), math::Vector2f(thickness, height + 2 * thickness)),
+        Body(math::Vector2f(-thickness, -thickness), math::Vector2f(width + 2 * thickness, thickness)),
+        Body(math::Vector2f(-thickness, height), math::Vector2f(width + 2 * thickness, thickness))
+    };
+
+    for(int i = 0; i < MAX_IMPACTS; i++){
+        if(displacement.x == 0.0f && displacement.y == 0.0f){
+            return;
+        }
+
+        float time = 1.0f, t;
+        sim::Direction face = sim::Direction::NONE, f;
+        const Body* hit = nullptr;
+        bool wall = false;
+
+        // A straight move that ends inside the field cannot have touched a wall
+        Body body = entities.getBody(ball);
+        math::Vector2f start = body.getPosition();
+        math::Vector2f to = start + displacement;
+        if(to.x < 0 || to.y < 0 || to.x + body.getScale().x > width || to.y + body.getScale().y > height){
+            for(const Body& w : walls){
+                if(body.sweep(w, displacement, t, f) && t < time){
+                    time = t;
+                    face = f;
+                    hit = &w;
+                    wall = true;
+                }
+            }
+        }
+
+        const std::vector<int>& nearby = nearbyTiles(std::min(start.x, to.x), std::min(start.y, to.y),
+                                                     std::max(start.x, to.x) + body.getScale().x, std::max(start.y, to.y) + body.getScale().y);
+        for(int index : nearby){
+            const Tile& tile = tiles[index];
+            if(body.sweep(tile, displacement, t, f) && t < time){
+                time = t;
+                face = f;
+                hit = &tile;
+                wall = false;
+            }
+        }
+
+        if(hit == nullptr){
+            entities.setPosition(ball, start + displacement);
+            return;
+        }
+
+        entities.setPosition(ball, start + displacement * time);
+        bounce(ball, *hit, face);
+
+        displacement = displacement * (1.0f - time);
+        if(face == sim::Direction::LEFT || face == sim::Direction::RIGHT){
+            displacement.x = -displacement.x;
+        }
+        else {
+            displacement.y = -displacement.y;
+        }
+
+        emit(wall ? EventType::WALL_COLLISION : EventType::TILE_COLLISION, ball);
+    }
+}
+
+const std::vector<int>& sim::World::nearbyTiles(float min_x, float min_y, float max_x, float max_y) const {
+    candidates.clear();
+
+    // Tiles added since the last build are not in the grid yet, every tile is a candidate until step rebuilds it
+    if(broadphase != Broadphase::BRUTE_FORCE && !grid_stale){
+        grid.query(min_x, min_y, max_x, max_y, candidates);
+    }
+    else {
+        for(size_t i = 0; i < tiles.size(); i++){
+            candidates.push_back(i);
+        }
+    }
+
+    return candidates;
+}
+
+void sim::World::bounce(size_t ball, const Body& body, Direction dir){
+    BallBatch& motion = entities.motion;
+    const math::Vector2f& extent = entities.extent[ball];
+
+    if(dir == sim::Direction::LEFT){
+        motion.x[ball] = body.getPosition().x - extent.x;
+        motion.vx[ball] = -motion.vx[ball];
+    } else if(dir == sim::Direction::RIGHT){
+        motion.x[ball] = body.getPosition().x + body.getScale().x;
+        motion.vx[ball] = -motion.vx[ball];
+    } else if(dir == sim::Direction::UP){
+        motion.y[ball] = body.getPosition().y - extent.y;
+        motion.vy[ball] = -motion.vy[ball];
+    } else if(dir == sim::Direction::DOWN){
+        motion.y[ball] = body.getPosition().y + body.getScale().y;
+        motion.vy[ball] = -motion.vy[ball];
+    }
+}
+
+// Same steps as Ball::shrink, the box loses amount and stays centred
+void sim::World::shrink(size_t ball, float amount){
+    math::Vector2f& extent = entities.extent[ball];
+    extent = math::Vector2f(extent.x - amount, extent.y - amount);
+    entities.motion.x[ball] = entities.motion.x[ball] + amount / 2.0f;
+    entities.motion.y[ball] = entities.motion.y[ball] + amount / 2.0f;
+}
+
+void sim::World::emit(EventType type, size_t ball){
+    events.push_back({type, entities.motion.speed[ball]});
+}
+
+void sim::World::collideOthers(){
+    size_t i = 1;
+    while(i < entities.size()){
+        if(!rolling[i]){
+            i++;
+            continue;
+        }
+
+        if(collisions == CollisionMode::SWEPT){
+            sweep(i, starts[i]);
+        }
+        else {
+            checkWalls(i);
+        }
+
+        if(captures(i)){
+            emit(EventType::HOLE_IN, i);
+            starts.erase(starts.begin() + i);
+            rolling.erase(rolling.begin() + i);
+            removeBall(i);
+            continue;
+        }
+
+        if(collisions == CollisionMode::DISCRETE && entities.isMoving(i)){
+            checkCollisions(i);
+        }
+        i++;
+    }
+
+    collideBalls();
+}
+
+void sim::World::removeBall(size_t index){
+    entities.destroy(entities.getId(index));
+
+    // The rest keep their order, so the sorted indices only need shifting down past the gap
+    uint32_t removed = index;
+    order.erase(std::remove(order.begin(), order.end(), removed), order.end());
+    for(uint32_t& o : order){
+        if(o > removed){
+            o--;
+        }
+    }
+}
+
+void sim::World::collideBalls(){
+    PROFILE_SCOPE("collideBalls");
+
+    uint32_t count = entities.size();
+
+    // The player ball sits in the hole once it is in and takes no part
+    uint32_t first = win ? 1 : 0;
+
+    pairs.clear();
+
+    if(broadphase != Broadphase::SORT_AND_SWEEP){
+        for(uint32_t a = first; a < count; a++){
+            for(uint32_t b = a + 1; b < count; b++){
+                if(touches(a, b)){
+                    pairs.push_back(std::make_pair(a, b));
+                }
+            }
+        }
+    }
+    else {
+        if(order.size() != count){
+            order.resize(count);
+            for(uint32_t i = 0; i < count; i++){
+                order[i] = i;
+            }
+        }
+
+        // Balls move a little per tick so last tick's order is nearly sorted and insertion sort runs close to linear.
+        // The keys sit next to the indices so the sort and the sweep stay off the position lanes
+        keys.resize(count);
+        for(size_t i = 0; i < order.size(); i++){
+            keys[i] = entities.motion.x[order[i]];
+        }
+
+        for(size_t i = 1; i < order.size(); i++){
+            uint32_t id = order[i];
+            float x = keys[i];
+            size_t j = i;
+            while(j > 0 && keys[j - 1] > x){
+                order[j] = order[j - 1];
+                keys[j] = keys[j - 1];
+                j--;
+            }
+            order[j] = id;
+            keys[j] = x;
+        }
+
+        for(size_t i = 0; i < order.size(); i++){
+            if(order[i] < first){
+                continue;
+            }
+
+            float max_x = keys[i] + entities.extent[order[i]].x;
+
+            for(size_t j = i + 1; j < order.size() && keys[j] <= max_x; j++){
+                if(order[j] >= first && touches(order[i], order[j])){
+                    pairs.push_back(std::minmax(order[i], order[j]));
+                }
+            }
+        }
+
+        // Same order the brute force loop finds them in
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    for(const std::pair<uint32_t, uint32_t>& pair : pairs){
+        resolve(pair.first, pair.second);
+    }
+}
+
+bool sim::World::touches(uint32_t a, uint32_t b) const {
+    const std::vector<float>& x = entities.motion.x;
+    const std::vector<float>& y = entities.motion.y;
+    const std::vector<math::Vector2f>& extent = entities.extent;
+    return x[a] <= x[b] + extent[b].x && x[b] <= x[a] + extent[a].x &&
+           y[a] <= y[b] + extent[b].y && y[b] <= y[a] + extent[a].y;
+}
+
+void sim::World::resolve(uint32_t a, uint32_t b){
+    BallBatch& motion = entities.motion;
+    const math::Vector2f& a_extent = entities.extent[a];
+    const math::Vector2f& b_extent = entities.extent[b];
+
+    math::Vector2f delta = entities.getBody(b).getCenter() - entities.getBody(a).getCenter();
+    float reach = (a_extent.x + b_extent.x) / 2.0f;
+    float distance_squared = delta.x * delta.x + delta.y * delta.y;
+    if(distance_squared >= reach * reach || distance_squared == 0.0f){
+        return;
+    }
+
+    float distance = sqrt(distance_squared);
+    math::Vector2f normal = delta / distance;
+
+    // Push both apart by half the overlap. One with a wall or tile right behind it stays and the other
+    // takes the whole overlap, two stuck balls stay overlapped until one rolls away
+    math::Vector2f push = normal * ((reach - distance) / 2.0f);
+    math::Vector2f a_position = entities.getPosition(a);
+    math::Vector2f b_position = entities.getPosition(b);
+    bool a_free = fits(a, a_position - push);
+    bool b_free = fits(b, b_position + push);
+    if(a_free && b_free){
+        entities.setPosition(a, a_position - push);
+        entities.setPosition(b, b_position + push);
+    }
+    else if(a_free){
+        entities.setPosition(a, a_position - (fits(a, a_position - push * 2) ? push * 2 : push));
+    }
+    else if(b_free){
+        entities.setPosition(b, b_position + (fits(b, b_position + push * 2) ? push * 2 : push));
+    }
+
+    // Equal masses, a perfectly elastic hit swaps the velocity components along the normal
+    math::Vector2f relative = entities.getVelocity(b) - entities.getVelocity(a);
+    float closing = relative.x * normal.x + relative.y * normal.y;
+    if(closing >= 0.0f){
+        return;
+    }
+
+    entities.setVelocity(a, entities.getVelocity(a) + normal * closing);
+    entities.setVelocity(b, entities.getVelocity(b) - normal * closing);
+
+    for(uint32_t ball : {a, b}){
+        math::Vector2f velocity = entities.getVelocity(ball);
+        motion.speed[ball] = (velocity / 10).magnitude();
+        motion.moving[ball] = velocity.x != 0.0f || velocity.y != 0.0f ? UINT32_MAX : 0;
+    }
+
+    emit(EventType::BALL_COLLISION, motion.speed[a] > motion.speed[b] ? a : b);
+}
+
+bool sim::World::fits(size_t ball, math::Vector2f position) const {
+    math::Vector2f scale = entities.extent[ball];
+    if(position.x < 0 || position.y < 0 || position.x + scale.x > width || position.y + scale.y > height){
+        return false;
+    }
+
+    Body body(position, scale);
+    for(int i : nearbyTiles(position.x, position.y, position.x + scale.x, position.y + scale.y)){
+        if(body.collidesWith(tiles[i]) != Direction::NONE){
+            return false;
+        }
+    }
+    return true;
+}
+
+void sim::World::placeBalls(){
+    clearBalls();
+
+    for(int i = 0; i < scatter; i++){
+        // Rejection sampling, a crowded field simply ends up with fewer balls
+        for(int attempt = 0; attempt < 100; attempt++){
+            math::Vector2f position(random.uniform(0.0f, width - ball_scale.x), random.uniform(0.0f, height - ball_scale.y));
+            Body body(position, ball_scale);
+
+            // Keep a ball's width of space to everything so nothing starts touching
+            Body space(position - ball_scale, ball_scale * 3);
+            bool blocked = space.collidesWith(hole) != Direction::NONE;
+            for(size_t j = 0; j < entities.size() && !blocked; j++){
+                blocked = space.collidesWith(Body(entities.getPosition(j), entities.extent[j])) != Direction::NONE;
+            }
+
+            const std::vector<int>& nearby = nearbyTiles(position.x, position.y, position.x + ball_scale.x, position.y + ball_scale.y);
+            for(size_t j = 0; j < nearby.size() && !blocked; j++){
+                blocked = body.collidesWith(tiles[nearby[j]]) != Direction::NONE;
+            }
+
+            if(!blocked){
+                addBall(position);
+                break;
+            }
+        }
+    }
+}
+
+void sim::World::setBallScale(float x, float y){
+    ball_scale = math::Vector2f(x, y);
+    entities.extent[0] = ball_scale;
+}
+
+void sim::World::setScatter(int count){
+    scatter = count;
+}
+
+int sim::World::getScatter() const {
+    return scatter;
+}
+
+void sim::World::addBall(math::Vector2f position){
+    entities.create(Ball(position, ball_scale));
+}
+
+void sim::World::clearBalls(){
+    // Only the player ball is left, back at id 0 so ids never outgrow one course
+    Ball ball = entities.getBall(0);
+    entities.clear();
+    entities.create(ball);
+    order.clear();
+}
+
+void sim::World::setHoleScale(float x, float y){
+    hole.setScale(x, y);
+}
+
+void sim::World::addTile(float w, float h){
+    tiles.push_back(Tile(math::Vector2f(0.0f, 0.0f), math::Vector2f(w, h)));
+    tile_set.push_back(tiles.back());
+
+    // Built once for the whole batch, on the next step or randomize, rather than once per tile
+    grid_stale = true;
+}
+
+sim::Ball sim::World::getBall() const {
+    return entities.getBall(0);
+}
+
+sim::EntityStore& sim::World::getEntities(){
+    return entities;
+}
+
+const sim::EntityStore& sim::World::getEntities() const {
+    return entities;
+}
+
+bool sim::World::isMoving() const {
+    for(size_t i = 0; i < entities.size(); i++){
+        if(entities.isMoving(i)){
+            return true;
+        }
+    }
+    return false;
+}
+
+sim::Body& sim::World::getHole(){
+    return hole;
+}
+
+const sim::Body& sim::World::getHole() const {
+    return hole;
+}
+
+std::vector<sim::Tile>& sim::World::getTiles(){
+    return tiles;
+}
+
+const std::vector<sim::Tile>& sim::World::getTiles() const {
+    return tiles;
+}
+
+const std::vector<sim::Event>& sim::World::getEvents() const {
+    return events;
+}
+
+void sim::World::clearEvents(){
+    events.clear();
+}
+
+bool sim::World::hasWon() const {
+    return win;
+}
+
+int sim::World::getWidth() const {
+    return width;
+}
+
+int sim::World::getHeight() const {
+    return height;
+}
@@ -0,0 +1,206 @@
+#ifndef SIM_WORLD_H
+#define SIM_WORLD_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Ball.h"
+#include "EntityStore.h"
+#include "Tile.h"
+#include "Event.h"
+#include "Course.h"
+#include "Grid.h"
+#include "CourseFile.h"
+#include "Random.h"
+
+namespace sim {
+
+enum MotionMode {
+    STEPPED,
+    EVENT_DRIVEN
+};
+
+enum CollisionMode {
+    DISCRETE,
+    SWEPT
+};
+
+// Tiles go through the grid with GRID and SORT_AND_SWEEP, balls against balls through sort and sweep
+// only with SORT_AND_SWEEP, everything else is tested pair by pair
+enum Broadphase {
+    BRUTE_FORCE,
+    GRID,
+    SORT_AND_SWEEP
+};
+
+class World
+{
+    public:
+        World();
+
+        World(int width, int height, uint64_t seed);
+
+        // advance then collide
+        void step(float dt);
+
+        // The two halves of step, apart so the caller can time them: every rolling ball moves by its velocity,
+        // then walls, tiles, the hole and other balls push back. Always call both, in this order
+        void advance(float dt);
+        void collide();
+
+        // Runs until every ball stops or max_ticks pass, returns the ticks simulated
+        int settle(float dt, int max_ticks);
+
+        // Ticks until the next bounce, hole, friction change or stop, see Trajectory
+        int nextEventTick(float dt) const;
+
+        // Moves the ball ticks steps along its closed form path without any collision checks
+        void jump(float dt, int ticks);
+
+        void setMotionMode(MotionMode mode);
+        MotionMode getMotionMode() const;
+
+        void setCollisionMode(CollisionMode collisions);
+        CollisionMode getCollisionMode() const;
+
+        // BRUTE_FORCE tests every tile and every pair of balls and exists to verify the other two,
+        // all three give the same results
+        void setBroadphase(Broadphase broadphase);
+        Broadphase getBroadphase() const;
+
+        // Needed after moving tiles through getTiles(), randomize and load do it already, addTile leaves it to the next step
+        void rebuildBroadphase();
+
+        bool shoot(math::Vector2f aim);
+
+        void reset();
+        void randomize();
+
+        // The loaded tiles become the ones randomize places from then on
+        void load(const Course& course);
+        void load(const CourseFile& file);
+        Course getCourse() const;
+
+        void setBallScale(float x, float y);
+        void setHoleScale(float x, float y);
+        // Every randomize places all tiles added so far, one that finds no room is left out of that course only
+        void addTile(float w, float h);
+
+        // Resting balls strewn over the field every time a course starts, the player only shoots getBall()
+        // and the others move when something hits them. Balls that drop in the hole leave the world
+        void setScatter(int count);
+        int getScatter() const;
+
+        void addBall(math::Vector2f position);
+        void clearBalls();
+
+        // A copy, the player ball lives in the entity store like every other
+        Ball getBall() const;
+
+        // Every ball, the player's at index 0 and the others after it
+        EntityStore& getEntities();
+        const EntityStore& getEntities() const;
+
+        // Whether any ball, the player's or another, is still rolling
+        bool isMoving() const;
+
+        Body& getHole();
+        const Body& getHole() const;
+
+        std::vector<Tile>& getTiles();
+        const std::vector<Tile>& getTiles() const;
+
+        const std::vector<Event>& getEvents() const;
+        void clearEvents();
+
+        bool hasWon() const;
+
+        int getWidth() const;
+
+        int getHeight() const;
+
+        static constexpr float MAX_POWER = 100.0f;
+        static constexpr float POWER_SCALE = 10.0f;
+        static constexpr float HOLE_RADIUS = 7.5f;
+        static constexpr float HOLE_MAX_SPEED = 70.0f;
+
+        // Impacts resolved inside one swept step, whatever movement is left after that is dropped
+        static constexpr int MAX_IMPACTS = 8;
+
+        // Grid cells nextEventTick searches ahead for tiles
+        static constexpr float EVENT_HORIZON = 4.0f;
+
+    private:
+        // The narrow phase takes balls by their index in the store and works on its lanes in place
+        void checkWalls(size_t ball);
+        void checkHole();
+        void checkCollisions(size_t ball);
+
+        void sweep(size_t ball, math::Vector2f from);
+        void bounce(size_t ball, const Body& body, Direction dir);
+        void shrink(size_t ball, float amount);
+
+        bool captures(size_t ball) const;
+
+        void collideOthers();
+        void removeBall(size_t index);
+
+        // Ball against ball, pairs come from a sort and sweep along x over the order kept from the last tick
+        void collideBalls();
+        void resolve(uint32_t a, uint32_t b);
+
+        // Inside the field and clear of every tile, resolve() pushes balls nowhere else
+        bool fits(size_t ball, math::Vector2f position) const;
+
+        // Bounding boxes of the balls at these indices overlap or touch, the pairs resolve() gets to look at
+        bool touches(uint32_t a, uint32_t b) const;
+
+        void placeBalls();
+
+        const std::vector<int>& nearbyTiles(float min_x, float min_y, float max_x, float max_y) const;
+
+        void emit(EventType type, size_t ball);
+
+        int width, height;
+
+        // Carried from advance to collide: the tick length, where every ball started and which were rolling
+        float step_dt = 0.0f;
+        std::vector<math::Vector2f> starts;
+        std::vector<uint8_t> rolling;
+
+        // Index 0 is the player ball
+        EntityStore entities;
+        std::vector<uint32_t> order;
+        std::vector<float> keys;
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        int scatter = 0;
+
+        Body hole;
+        std::vector<Tile> tiles;
+        math::Vector2f ball_scale;
+
+        // Tiles randomize starts from, tiles holds those that found a place
+        std::vector<Tile> tile_set;
+
+        // Scratch for randomize, kept so course resets reuse their buffers
+        Course layout;
+        std::vector<int> cells;
+
+        Grid grid;
+        bool grid_stale = false;
+        mutable std::vector<int> candidates;
+
+        std::vector<Event> events;
+
+        bool win = false;
+
+        MotionMode mode = MotionMode::STEPPED;
+        CollisionMode collisions = CollisionMode::SWEPT;
+        Broadphase broadphase = Broadphase::SORT_AND_SWEEP;
+
+        Random random;
+};
+}
+
+#endif // SIM_WORLD_H
@@ -0,0 +1,180 @@
+#ifndef TOOLS_SOCKET_H
+#define TOOLS_SOCKET_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Stream sockets for the match server and its load generator, POSIX only like the two tools.
+// An address is unix:<path> for a local socket or [host:]port for TCP, host defaults to loopback
+namespace net {
+
+struct Address {
+    bool local = false;
+    std::string path;
+    std::string host = "127.0.0.1";
+    std::string port;
+};
+
+inline Address parseAddress(const std::string& text){
+    Address address;
+    if(text.compare(0, 5, "unix:") == 0){
+        address.local = true;
+        address.path = text.substr(5);
+        return address;
+    }
+
+    size_t colon = text.rfind(':');
+    if(colon == std::string::npos){
+        address.port = text;
+    }
+    else {
+        address.host = text.substr(0, colon);
+        address.port = text.substr(colon + 1);
+    }
+    return address;
+}
+
+inline bool setNonBlocking(int fd){
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Small frames go out as soon as they are written instead of waiting on Nagle
+inline void setNoDelay(int fd){
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+// Either a local socket or the first TCP address the lookup gives, bound or connected. -1 on failure
+inline int openSocket(const std::string& text, bool server){
+    Address address = parseAddress(text);
+
+    if(address.local){
+        sockaddr_un local;
+        memset(&local, 0, sizeof(local));
+        local.sun_family = AF_UNIX;
+        if(address.path.size() >= sizeof(local.sun_path)){
+            return -1;
+        }
+        memcpy(local.sun_path, address.path.c_str(), address.path.size());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0){
+            return -1;
+        }
+
+        if(server){
+            // Left behind by a server that did not shut down cleanly
+            unlink(address.path.c_str());
+        }
+
+        int result = server ? bind(fd, (sockaddr*)&local, sizeof(local)) : connect(fd, (sockaddr*)&local, sizeof(local));
+        if(result != 0 || (server && listen(fd, SOMAXCONN) != 0)){
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* found = nullptr;
+    if(getaddrinfo(address.host.c_str(), address.port.c_str(), &hints, &found) != 0 || found == nullptr){
+        return -1;
+    }
+
+    int fd = socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+    if(fd >= 0){
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+        int result = server ? bind(fd, found->ai_addr, found->ai_addrlen) : connect(fd, found->ai_addr, found->ai_addrlen);
+        if(result != 0 || (server && listen(fd, SOMAXCONN) != 0)){
+            ::close(fd);
+            fd = -1;
+        }
+        else {
+            setNoDelay(fd);
+        }
+    }
+
+    freeaddrinfo(found);
+    return fd;
+}
+
+inline int listenOn(const std::string& address){
+    return openSocket(address, true);
+}
+
+inline int connectTo(const std::string& address){
+    return openSocket(address, false);
+}
+
+// One end of a stream with a buffer each way, the owner decodes frames out of in and encodes into out
+struct Connection {
+    int fd = -1;
+    std::string in;
+    std::string out;
+
+    // Appends whatever arrived to in, false once the peer closed or the socket failed
+    bool receive(){
+        char buffer[65536];
+        while(true){
+            ssize_t count = read(fd, buffer, sizeof(buffer));
+            if(count > 0){
+                in.append(buffer, count);
+                continue;
+            }
+            if(count == 0){
+                return false;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+    }
+
+    // Writes as much of out as the socket takes right now, false when the socket failed
+    bool flush(){
+        size_t written = 0;
+        while(written < out.size()){
+            ssize_t count = write(fd, out.data() + written, out.size() - written);
+            if(count > 0){
+                written += count;
+                continue;
+            }
+            if(count < 0 && errno == EINTR){
+                continue;
+            }
+            if(count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+                break;
+            }
+            return false;
+        }
+
+        out.erase(0, written);
+        return true;
+    }
+
+    void close(){
+        if(fd >= 0){
+            ::close(fd);
+            fd = -1;
+        }
+    }
+};
+}
+
+#endif // TOOLS_SOCKET_H
@@ -0,0 +1,148 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Packs images into one texture and writes the sub-rect table read by sdl::Atlas
+// usage: atlas <out.png> <out.txt> <image>...
+
+// Every image is extruded by one pixel so linear filtering never samples a neighbour
+const int BORDER = 1;
+
+struct Entry {
+    std::string name;
+    SDL_Surface* surface;
+    SDL_Rect rect;
+};
+
+static std::string baseName(const std::string& path){
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+// Shelf packing into a fixed width, entries are expected tallest first
+static int pack(std::vector<Entry>& entries, int width){
+    int x = 0, y = 0, shelf = 0;
+    for(Entry& entry : entries){
+        int w = entry.surface->w + BORDER * 2;
+        int h = entry.surface->h + BORDER * 2;
+        if(x + w > width){
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+        entry.rect = {x + BORDER, y + BORDER, entry.surface->w, entry.surface->h};
+        x += w;
+        shelf = std::max(shelf, h);
+    }
+    return y + shelf;
+}
+
+static void blit(SDL_Surface* source, int sx, int sy, int w, int h, SDL_Surface* target, int tx, int ty){
+    SDL_Rect from = {sx, sy, w, h};
+    SDL_Rect to = {tx, ty, w, h};
+    SDL_BlitSurface(source, &from, target, &to);
+}
+
+int main(int argc, char* args[]){
+    if(argc < 4){
+        fprintf(stderr, "usage: %s <out.png> <out.txt> <image>...\n", args[0]);
+        return 1;
+    }
+
+    if(SDL_Init(0) < 0 || (IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG) & IMG_INIT_PNG) == 0){
+        fprintf(stderr, "Failed to initialise SDL_image\n");
+        return 1;
+    }
+
+    std::vector<Entry> entries;
+    int area = 0, widest = 0;
+    for(int i = 3; i < argc; i++){
+        SDL_Surface* loaded = IMG_Load(args[i]);
+        if(loaded == nullptr){
+            fprintf(stderr, "Failed to load image %s\n", args[i]);
+            return 1;
+        }
+
+        SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+        SDL_FreeSurface(loaded);
+        if(surface == nullptr){
+            fprintf(stderr, "Failed to convert image %s\n", args[i]);
+            return 1;
+        }
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+
+        entries.push_back({baseName(args[i]), surface, {0, 0, 0, 0}});
+        area += (surface->w + BORDER * 2) * (surface->h + BORDER * 2);
+        widest = std::max(widest, surface->w + BORDER * 2);
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b){
+        return a.surface->h != b.surface->h ? a.surface->h > b.surface->h : a.name < b.name;
+    });
+
+    // Smallest power of two width that keeps the sheet no taller than it is wide
+    int width = 1;
+    while(width < widest || width * width < area){
+        width *= 2;
+    }
+    int height = pack(entries, width);
+    while(height > width){
+        width *= 2;
+        height = pack(entries, width);
+    }
+
+    SDL_Surface* sheet = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA32);
+    if(sheet == nullptr){
+        fprintf(stderr, "Failed to create a %dx%d sheet\n", width, height);
+        return 1;
+    }
+    SDL_FillRect(sheet, nullptr, 0);
+
+    for(const Entry& entry : entries){
+        SDL_Surface* s = entry.surface;
+        int x = entry.rect.x, y = entry.rect.y, w = s->w, h = s->h;
+
+        blit(s, 0, 0, w, h, sheet, x, y);
+
+        blit(s, 0, 0, w, 1, sheet, x, y - 1);
+        blit(s, 0, h - 1, w, 1, sheet, x, y + h);
+        blit(s, 0, 0, 1, h, sheet, x - 1, y);
+        blit(s, w - 1, 0, 1, h, sheet, x + w, y);
+
+        blit(s, 0, 0, 1, 1, sheet, x - 1, y - 1);
+        blit(s, w - 1, 0, 1, 1, sheet, x + w, y - 1);
+        blit(s, 0, h - 1, 1, 1, sheet, x - 1, y + h);
+        blit(s, w - 1, h - 1, 1, 1, sheet, x + w, y + h);
+    }
+
+    if(IMG_SavePNG(sheet, args[1]) != 0){
+        fprintf(stderr, "Failed to write %s\n", args[1]);
+        return 1;
+    }
+
+    std::ofstream table(args[2]);
+    if(!table){
+        fprintf(stderr, "Failed to write %s\n", args[2]);
+        return 1;
+    }
+
+    std::string image = args[1];
+    table << "image " << image.substr(image.find_last_of("/\\") + 1) << "\n";
+    for(const Entry& entry : entries){
+        table << "region " << entry.name << " " << entry.rect.x << " " << entry.rect.y << " " << entry.rect.w << " " << entry.rect.h << "\n";
+        SDL_FreeSurface(entry.surface);
+    }
+
+    printf("%dx%d, %zu images, %.1f%% used\n", width, height, entries.size(), 100.0 * area / (width * height));
+
+    SDL_FreeSurface(sheet);
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,804 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../Compositor.h"
+#include "../Vector2f.h"
+#include "../sim/Ball.h"
+#include "../sim/BallBatch.h"
+#include "../sim/Body.h"
+#include "../sim/Course.h"
+#include "../sim/EntityStore.h"
+#include "../sim/Preview.h"
+#include "../sim/Random.h"
+#include "../sim/Tile.h"
+#include "../sim/World.h"
+
+#ifndef NO_SDL
+#include <SDL2/SDL.h>
+
+#include "../RenderWindow.h"
+#include "../Sprite.h"
+#include "../StaticLayer.h"
+#endif
+
+// Micro and end to end benchmarks, run from the repository root so res/ resolves
+// usage: bench [--json <out.json>] [--baseline <in.json>] [--threshold <percent>]
+//              [--filter <substring>] [--min-time <seconds>]
+// With --baseline the exit code is 1 when any benchmark got slower than the threshold, it is 1 without timing
+// anything when a BallBatch kernel does not match Ball::update bit for bit
+
+struct Result {
+    std::string name;
+    double ns_per_op;
+    uint64_t iterations;
+};
+
+// Keeps the compiler from dropping work whose result is never read
+template <typename T>
+inline void keep(const T& value){
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+const int REPEATS = 5;
+
+std::string filter;
+double min_time = 0.2;
+std::vector<Result> results;
+
+// body(n) performs the operation n times. The count doubles until one run takes min_time / REPEATS,
+// then the median of REPEATS runs is reported
+void bench(const std::string& name, const std::function<void(uint64_t)>& body){
+    if(!filter.empty() && name.find(filter) == std::string::npos){
+        return;
+    }
+
+    double target = min_time / REPEATS;
+    uint64_t iterations = 1;
+    double elapsed = 0.0;
+    while(true){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body(iterations);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(elapsed >= target || iterations >= (1ull << 40)){
+            break;
+        }
+        iterations = elapsed > 0.0 ? std::max(iterations * 2, (uint64_t)(iterations * target / elapsed * 1.2)) : iterations * 2;
+    }
+
+    std::vector<double> times;
+    for(int i = 0; i < REPEATS; i++){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        body(iterations);
+        times.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations);
+    }
+    std::sort(times.begin(), times.end());
+
+    Result result = {name, times[REPEATS / 2], iterations};
+    results.push_back(result);
+    printf("%-44s %14.2f ns/op %12llu iterations\n", name.c_str(), result.ns_per_op, (unsigned long long)iterations);
+}
+
+void benchVector(){
+    sim::Random random(1);
+    std::vector<math::Vector2f> a(1024), b(1024);
+    for(size_t i = 0; i < a.size(); i++){
+        a[i] = math::Vector2f(random.uniform(1.0f, 100.0f), random.uniform(1.0f, 100.0f));
+        b[i] = math::Vector2f(random.uniform(-100.0f, 100.0f), random.uniform(-100.0f, 100.0f));
+    }
+
+    bench("vector2f/add_scale", [&](uint64_t n){
+        for(uint64_t i = 0; i < n; i++){
+            size_t k = i & 1023;
+            a[k] = a[k] + b[k] * 0.5f - a[k] * 0.5f;
+        }
+        keep(a);
+    });
+
+    bench("vector2f/magnitude", [&](uint64_t n){
+        float sum = 0.0f;
+        for(uint64_t i = 0; i < n; i++){
+            sum += a[i & 1023].magnitude();
+        }
+        keep(sum);
+    });
+
+    bench("vector2f/dot", [&](uint64_t n){
+        float sum = 0.0f;
+        for(uint64_t i = 0; i < n; i++){
+            sum += math::dot(a[i & 1023], b[i & 1023]);
+        }
+        keep(sum);
+    });
+
+    bench("vector2f/normalize", [&](uint64_t n){
+        float sum = 0.0f;
+        for(uint64_t i = 0; i < n; i++){
+            math::Vector2f v = a[i & 1023];
+            v.normalize();
+            sum += v.x;
+        }
+        keep(sum);
+    });
+}
+
+void benchCollides(){
+    // Half of the neighbouring pairs overlap
+    sim::Random random(2);
+    std::vector<sim::Body> bodies;
+    for(int i = 0; i < 1024; i++){
+        bodies.push_back(sim::Body(math::Vector2f(random.uniform(0.0f, 64.0f), random.uniform(0.0f, 64.0f)), math::Vector2f(32, 32)));
+    }
+
+    bench("body/collidesWith", [&](uint64_t n){
+        int sum = 0;
+        for(uint64_t i = 0; i < n; i++){
+            sum += bodies[i & 1023].collidesWith(bodies[(i + 1) & 1023]);
+        }
+        keep(sum);
+    });
+
+#ifndef NO_SDL
+    std::vector<sdl::Sprite> sprites(1024);
+    for(size_t i = 0; i < sprites.size(); i++){
+        sprites[i].setPosition(bodies[i].getPosition());
+        sprites[i].setScale(bodies[i].getScale());
+    }
+
+    bench("sprite/collidesWith", [&](uint64_t n){
+        int sum = 0;
+        for(uint64_t i = 0; i < n; i++){
+            sum += sprites[i & 1023].collidesWith(sprites[(i + 1) & 1023]);
+        }
+        keep(sum);
+    });
+#endif
+}
+
+void benchBall(){
+    // Strongest shot World::shoot allows, rolled out until the ball stops
+    bench("ball/update_full_shot", [&](uint64_t n){
+        for(uint64_t i = 0; i < n; i++){
+            sim::Ball ball(math::Vector2f(0, 0), math::Vector2f(16, 16));
+            ball.setVelocity(math::Vector2f(0.6f, 0.8f) * (sim::World::MAX_POWER * sim::World::POWER_SCALE));
+            ball.setMoving(true);
+            while(ball.isMoving()){
+                ball.update(0.016f);
+            }
+            keep(ball.getPosition());
+        }
+    });
+}
+
+// Kernels BallBatch can run here, scalar always
+std::vector<sim::BatchKernel> batchKernels(){
+    std::vector<sim::BatchKernel> kernels;
+    for(sim::BatchKernel kernel : {sim::BatchKernel::SCALAR, sim::BatchKernel::SSE2, sim::BatchKernel::AVX2}){
+        if(kernel <= sim::BallBatch::detectKernel()){
+            kernels.push_back(kernel);
+        }
+    }
+    return kernels;
+}
+
+// Balls fast and slow in every direction, some at rest, so every branch of Ball::update is taken
+std::vector<sim::Ball> batchBalls(int count, uint64_t seed){
+    sim::Random random(seed);
+    std::vector<sim::Ball> balls;
+    for(int i = 0; i < count; i++){
+        sim::Ball ball(math::Vector2f(random.uniform(0, 480), random.uniform(0, 640)), math::Vector2f(16, 16));
+        float reach = i % 3 == 0 ? 20.0f : 1000.0f;
+        ball.setVelocity(random.uniform(-reach, reach), random.uniform(-reach, reach));
+        ball.setVelocity1D((ball.getVelocity() / 10).magnitude());
+        ball.setMoving(i % 7 != 0);
+        balls.push_back(ball);
+    }
+    return balls;
+}
+
+bool sameBits(float a, float b){
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Replays lean on BallBatch matching Ball::update bit for bit, every kernel is held to it before anything is timed.
+// Both the reference tick and another one, which takes the pow path of Ball::slowDecay
+bool checkBallBatch(){
+    for(sim::BatchKernel kernel : batchKernels()){
+        for(float dt : {0.016f, 0.01f}){
+            std::vector<sim::Ball> balls = batchBalls(253, 3);
+            sim::BallBatch batch;
+            for(const sim::Ball& ball : balls){
+                batch.add(ball);
+            }
+
+            for(int tick = 0; tick < 2000; tick++){
+                batch.update(dt, kernel);
+                for(size_t i = 0; i < balls.size(); i++){
+                    sim::Ball& ball = balls[i];
+                    ball.update(dt);
+
+                    sim::Ball lane = ball;
+                    batch.store(i, lane);
+                    if(!sameBits(lane.getPosition().x, ball.getPosition().x) || !sameBits(lane.getPosition().y, ball.getPosition().y) ||
+                       !sameBits(lane.getVelocity().x, ball.getVelocity().x) || !sameBits(lane.getVelocity().y, ball.getVelocity().y) ||
+                       !sameBits(lane.getVelocity1D(), ball.getVelocity1D()) || lane.isMoving() != ball.isMoving()){
+                        fprintf(stderr, "BallBatch %s differs from Ball::update in ball %zu after %d ticks of %.3f s\n",
+                                sim::BallBatch::kernelName(kernel), i, tick + 1, dt);
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// One tick of 256 balls, as Ball objects and through every batch kernel, restarted every 200 ticks
+void benchBallBatch(){
+    const std::vector<sim::Ball> start = batchBalls(256, 4);
+
+    bench("ball_batch/objects/balls=256", [&](uint64_t n){
+        std::vector<sim::Ball> balls;
+        for(uint64_t i = 0; i < n; i++){
+            if(i % 200 == 0){
+                balls = start;
+            }
+            for(sim::Ball& ball : balls){
+                ball.update(0.016f);
+            }
+        }
+        keep(balls[0].getPosition());
+    });
+
+    for(sim::BatchKernel kernel : batchKernels()){
+        bench(std::string("ball_batch/") + sim::BallBatch::kernelName(kernel) + "/balls=256", [&](uint64_t n){
+            sim::BallBatch batch;
+            for(uint64_t i = 0; i < n; i++){
+                if(i % 200 == 0){
+                    batch.clear();
+                    for(const sim::Ball& ball : start){
+                        batch.add(ball);
+                    }
+                }
+                batch.update(0.016f, kernel);
+            }
+            keep(batch.x[0]);
+        });
+    }
+}
+
+// count tiles on a regular grid with room to roll between them, the hole out of reach so shots never end
+sim::Course tileCourse(int count){
+    const int spacing = 128;
+    int columns = (int)std::ceil(std::sqrt((double)count));
+
+    sim::Course course;
+    course.width = columns * spacing + 64;
+    course.height = ((count + columns - 1) / columns) * spacing + 64;
+    course.ball_position = math::Vector2f(20, 20);
+    course.ball_scale = math::Vector2f(16, 16);
+    course.hole_position = math::Vector2f(-1000, -1000);
+    course.hole_scale = math::Vector2f(16, 16);
+
+    for(int i = 0; i < count; i++){
+        course.tiles.push_back(sim::Tile(math::Vector2f(64 + (i % columns) * spacing, 64 + (i / columns) * spacing), math::Vector2f(64, 64)));
+    }
+    return course;
+}
+
+void benchWorld(){
+    for(int count : {5, 50, 500, 3000}){
+        sim::Course course = tileCourse(count);
+
+        struct Variant {
+            const char* name;
+            sim::CollisionMode collisions;
+            sim::Broadphase broadphase;
+        };
+
+        for(const Variant& variant : {Variant{"discrete/brute", sim::CollisionMode::DISCRETE, sim::Broadphase::BRUTE_FORCE},
+                                      Variant{"discrete/grid", sim::CollisionMode::DISCRETE, sim::Broadphase::GRID},
+                                      Variant{"swept/grid", sim::CollisionMode::SWEPT, sim::Broadphase::GRID}}){
+            sim::World world;
+            world.setCollisionMode(variant.collisions);
+            world.setBroadphase(variant.broadphase);
+
+            // Every timed run replays the same shots from the start of the course
+            bench(std::string("world/step/") + variant.name + "/tiles=" + std::to_string(count), [&](uint64_t n){
+                world.load(course);
+                float angle = 0.3f;
+                for(uint64_t i = 0; i < n; i++){
+                    if(!world.getBall().isMoving()){
+                        angle += 0.7f;
+                        world.shoot(math::Vector2f(std::cos(angle), std::sin(angle)) * sim::World::MAX_POWER);
+                    }
+                    world.step(0.016f);
+                    world.clearEvents();
+                }
+                keep(world.getBall().getPosition());
+            });
+        }
+    }
+}
+
+// Scattered balls all rolling at once, sort and sweep against every pair
+void benchBalls(){
+    sim::Course course = tileCourse(50);
+
+    for(int count : {16, 128, 512}){
+        for(sim::Broadphase broadphase : {sim::Broadphase::BRUTE_FORCE, sim::Broadphase::SORT_AND_SWEEP}){
+            sim::World world(course.width, course.height, 1);
+            world.setBroadphase(broadphase);
+            world.setScatter(count);
+            world.load(course);
+
+            // Scattered and sent rolling once, outside the timing
+            sim::Random random(2);
+            sim::EntityStore& entities = world.getEntities();
+            std::vector<sim::Ball> start;
+            for(size_t b = 0; b < entities.size(); b++){
+                sim::Ball ball = entities.getBall(b);
+                if(b > 0){
+                    ball.setVelocity(random.uniform(-600, 600), random.uniform(-600, 600));
+                    ball.setVelocity1D((ball.getVelocity() / 10).magnitude());
+                    ball.setMoving(true);
+                }
+                start.push_back(ball);
+            }
+
+            // A crowded field places fewer than asked for, the name carries the count that really rolls
+            size_t placed = entities.size() - 1;
+
+            // Put back every 200 ticks, before the slowest ball stops
+            bench(std::string("world/balls/") + (broadphase == sim::Broadphase::SORT_AND_SWEEP ? "sweep_and_prune" : "brute") +
+                  "/balls=" + std::to_string(placed), [&](uint64_t n){
+                for(uint64_t i = 0; i < n; i++){
+                    if(i % 200 == 0){
+                        for(size_t b = 0; b < start.size(); b++){
+                            entities.setBall(b, start[b]);
+                        }
+                    }
+                    world.step(0.016f);
+                    world.clearEvents();
+                }
+                keep(world.getBall().getPosition());
+            });
+        }
+    }
+}
+
+// Aim preview on dense courses: a new aim bucket every call, then aims swept back and forth over the cached ones
+void benchPreview(){
+    for(int count : {50, 3000}){
+        sim::Course course = tileCourse(count);
+        sim::Preview preview(0.016f);
+        preview.setCourse(course);
+
+        bench("preview/run/tiles=" + std::to_string(count), [&](uint64_t n){
+            for(uint64_t i = 0; i < n; i++){
+                float angle = 0.3f + (i % 4096) * 0.0015f;
+                keep(preview.predict(math::Vector2f(std::cos(angle), std::sin(angle)) * (40.0f + i % 61)).back());
+            }
+        });
+
+        bench("preview/cached/tiles=" + std::to_string(count), [&](uint64_t n){
+            for(uint64_t i = 0; i < n; i++){
+                keep(preview.predict(math::Vector2f(60.0f + (i % 32), 30.0f)).back());
+            }
+        });
+    }
+}
+
+// Straight alpha disc, soft at the edge like the ball sprites
+sdl::Image discImage(int size, uint32_t color){
+    std::vector<uint32_t> pixels(size * size);
+    float radius = size / 2.0f;
+    for(int y = 0; y < size; y++){
+        for(int x = 0; x < size; x++){
+            float distance = std::hypot(x + 0.5f - radius, y + 0.5f - radius);
+            float coverage = std::min(1.0f, std::max(0.0f, radius - distance));
+            pixels[y * size + x] = ((uint32_t)(coverage * 255.0f) << 24) | (color & 0xFFFFFF);
+        }
+    }
+
+    sdl::Image image;
+    image.load(pixels.data(), size, size, size);
+    return image;
+}
+
+// Horizontal gradient from transparent to opaque, for the arrow and the power bar
+sdl::Image gradientImage(int width, int height, uint32_t color){
+    std::vector<uint32_t> pixels(width * height);
+    for(int y = 0; y < height; y++){
+        for(int x = 0; x < width; x++){
+            pixels[y * width + x] = ((uint32_t)(255 * x / (width - 1)) << 24) | (color & 0xFFFFFF);
+        }
+    }
+
+    sdl::Image image;
+    image.load(pixels.data(), width, height, width);
+    return image;
+}
+
+// The offscreen backend on synthetic sprites, once per SIMD level the CPU has. Frames are what App::render
+// draws while aiming with dirty regions on: last frame's rects copied back 1:1 from the static layer, a few
+// dozen balls, the rotated arrow and the clipped power bar. full_redraw copies the whole layer instead
+void benchCompositor(){
+    sdl::Simd best = sdl::getSimd();
+    std::vector<sdl::Simd> levels;
+    for(sdl::Simd simd : {sdl::Simd::SCALAR, sdl::Simd::SSE2, sdl::Simd::AVX2}){
+        if(simd <= best){
+            levels.push_back(simd);
+        }
+    }
+
+    sdl::Image ball = discImage(16, 0xFFFFFF);
+    sdl::Image arrow = gradientImage(64, 16, 0xE04040);
+    sdl::Image powerbar = gradientImage(12, 96, 0x40E040);
+
+    // Every alpha from 0 to 255, so nearly every vector goes through the blend
+    std::vector<uint32_t> row(1024), dst(1024);
+    for(size_t i = 0; i < row.size(); i++){
+        row[i] = arrow.getRow(0)[i % 64];
+    }
+
+    for(sdl::Simd simd : levels){
+        sdl::setSimd(simd);
+        bench(std::string("compositor/blend_row/") + sdl::simdName(simd) + "/pixels=1024", [&](uint64_t n){
+            for(uint64_t i = 0; i < n; i++){
+                std::fill(dst.begin(), dst.end(), 0xFF3CB043);
+                sdl::blendRow(dst.data(), row.data(), row.size());
+            }
+            keep(dst[0]);
+        });
+    }
+
+    for(int scale : {1, 2, 4}){
+        int width = 480 * scale, height = 640 * scale;
+
+        // Stands in for the static layer, opaque so drawing it is a copy
+        sdl::Image layer(width, height);
+        for(int y = 0; y < height; y++){
+            for(int x = 0; x < width; x++){
+                layer.getRow(y)[x] = 0xFF000000 | (((x ^ y) & 0x3F) << 10) | 0x200020;
+            }
+        }
+        layer.setOpaque(true);
+
+        sdl::Compositor compositor(width, height);
+        std::vector<sdl::Blit> dirty;
+
+        auto restore = [&](const sdl::Blit& rect){
+            sdl::Blit blit;
+            blit.x = rect.clip_x;
+            blit.y = rect.clip_y;
+            blit.w = rect.clip_w;
+            blit.h = rect.clip_h;
+            blit.clip_x = rect.clip_x;
+            blit.clip_y = rect.clip_y;
+            blit.clip_w = rect.clip_w;
+            blit.clip_h = rect.clip_h;
+            compositor.draw(layer, blit);
+        };
+
+        // Bounds of a drawn blit, as the clip of a 1:1 copy from the layer
+        auto track = [&](const sdl::Blit& blit, float extent){
+            sdl::Blit rect;
+            rect.clip_x = std::max(0, (int)std::floor(blit.x + blit.center_x - extent) - 1);
+            rect.clip_y = std::max(0, (int)std::floor(blit.y + blit.center_y - extent) - 1);
+            rect.clip_w = std::min(width, (int)std::ceil(blit.x + blit.center_x + extent) + 1) - rect.clip_x;
+            rect.clip_h = std::min(height, (int)std::ceil(blit.y + blit.center_y + extent) + 1) - rect.clip_y;
+            dirty.push_back(rect);
+        };
+
+        auto frame = [&](uint64_t i, sim::Random& random, bool full){
+            if(full){
+                sdl::Blit all;
+                all.clip_w = width;
+                all.clip_h = height;
+                compositor.clear(0xFFFFFFFF);
+                restore(all);
+            }
+            else {
+                for(const sdl::Blit& rect : dirty){
+                    restore(rect);
+                }
+            }
+            dirty.clear();
+
+            for(int b = 0; b < 32; b++){
+                sdl::Blit blit;
+                blit.x = random.uniform(0.0f, width - 16.0f * scale);
+                blit.y = random.uniform(0.0f, height - 16.0f * scale);
+                blit.w = blit.h = 16.0f * scale;
+                blit.clip_w = blit.clip_h = 16;
+                blit.center_x = blit.center_y = 8.0f * scale;
+                compositor.draw(ball, blit);
+                track(blit, 8.0f * scale);
+            }
+
+            sdl::Blit pointer;
+            pointer.x = width / 2.0f;
+            pointer.y = height / 2.0f - 8.0f * scale;
+            pointer.w = 64.0f * scale;
+            pointer.h = 16.0f * scale;
+            pointer.clip_w = 64;
+            pointer.clip_h = 16;
+            pointer.angle = (float)(i % 360);
+            pointer.center_y = pointer.h / 2.0f;
+            compositor.draw(arrow, pointer);
+            track(pointer, pointer.w);
+
+            int power = 1 + i % 96;
+            sdl::Blit bar;
+            bar.x = width / 2.0f + 15.0f * scale;
+            bar.y = height / 2.0f + (48.0f - power) * scale;
+            bar.w = 12.0f * scale;
+            bar.h = (float)power * scale;
+            bar.clip_y = 96 - power;
+            bar.clip_w = 12;
+            bar.clip_h = power;
+            bar.center_x = bar.w / 2.0f;
+            bar.center_y = bar.h / 2.0f;
+            compositor.draw(powerbar, bar);
+            track(bar, std::max(bar.w, bar.h) / 2.0f);
+        };
+
+        std::string size = std::to_string(width) + "x" + std::to_string(height);
+        for(sdl::Simd simd : levels){
+            sdl::setSimd(simd);
+            for(bool full : {false, true}){
+                std::string name = "compositor/" + std::string(full ? "full_redraw/" : "frame/") + size + "/" + sdl::simdName(simd);
+                bench(name, [&](uint64_t n){
+                    sim::Random random(3);
+                    frame(0, random, true);
+                    for(uint64_t i = 0; i < n; i++){
+                        frame(i, random, full);
+                    }
+                    keep(compositor.getFramebuffer().getRow(0)[0]);
+                });
+
+                if(!results.empty() && results.back().name == name){
+                    printf("%-44s %14.1f fps\n", "", 1e9 / results.back().ns_per_op);
+                }
+            }
+        }
+    }
+
+    sdl::setSimd(best);
+}
+
+#ifndef NO_SDL
+// Mirrors App::render on SDL's dummy video driver, once with the cached static layer and once redrawing everything
+void benchFrame(){
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    if(!sdl::initSDL(SDL_INIT_VIDEO, sdl::SDL_IMAGE, IMG_INIT_PNG | IMG_INIT_JPG)){
+        fprintf(stderr, "Skipping frame benchmarks, SDL failed to start: %s\n", SDL_GetError());
+        return;
+    }
+
+    {
+        sdl::RenderWindow window("bench", 480, 640);
+        window.setVSync(false);
+
+        sdl::Sprite ball, hole, tile, field;
+        try {
+            ball.setTexture(window.loadTextureFromFile("res/imgs/golf_ball.png"));
+            hole.setTexture(window.loadTextureFromFile("res/imgs/hole.png"));
+            tile.setTexture(window.loadTextureFromFile("res/imgs/tile.png"));
+            field.setTexture(window.loadTextureFromFile("res/imgs/field.jpg"));
+        }
+        catch(const std::runtime_error& error){
+            fprintf(stderr, "Skipping frame benchmarks, run from the repository root: %s\n", error.what());
+            sdl::quit(sdl::SDL_IMAGE);
+            return;
+        }
+
+        sim::World world;
+        float angle = 0.3f;
+
+        // Same seed for every timed run, so each one renders the same frames
+        auto setup = [&](sdl::StaticLayer& layer){
+            world = sim::World(window.getWidth(), window.getHeight(), 1);
+            world.setBallScale(ball.getScale().x, ball.getScale().y);
+            world.setHoleScale(hole.getScale().x, hole.getScale().y);
+            for(int i = 0; i < 5; i++){
+                world.addTile(tile.getScale().x, tile.getScale().y);
+            }
+            world.randomize();
+            angle = 0.3f;
+            layer.invalidate();
+        };
+
+        auto drawStatic = [&](){
+            window.render(field);
+            hole.setPosition(world.getHole().getPosition());
+            hole.setScale(world.getHole().getScale());
+            window.render(hole);
+            for(const sim::Tile& t : world.getTiles()){
+                tile.setPosition(t.getPosition());
+                tile.setScale(t.getScale());
+                window.render(tile);
+            }
+        };
+
+        auto frame = [&](bool cached, sdl::StaticLayer& layer){
+            if(!world.getBall().isMoving()){
+                if(world.hasWon()){
+                    world.reset();
+                    layer.invalidate();
+                }
+                angle += 0.7f;
+                world.shoot(math::Vector2f(std::cos(angle), std::sin(angle)) * sim::World::MAX_POWER);
+            }
+            world.step(0.016f);
+            world.clearEvents();
+
+            if(cached && !layer.isValid()){
+                layer.begin();
+                drawStatic();
+                layer.end();
+            }
+
+            window.clear();
+            if(cached){
+                layer.draw();
+            }
+            else {
+                drawStatic();
+            }
+            ball.setPosition(world.getBall().getPosition());
+            ball.setScale(world.getBall().getScale());
+            window.render(ball);
+            window.display();
+        };
+
+        sdl::StaticLayer layer(&window);
+        bench("frame/headless/static_layer", [&](uint64_t n){
+            setup(layer);
+            for(uint64_t i = 0; i < n; i++){
+                frame(true, layer);
+            }
+        });
+
+        bench("frame/headless/full_redraw", [&](uint64_t n){
+            setup(layer);
+            for(uint64_t i = 0; i < n; i++){
+                frame(false, layer);
+            }
+        });
+    }
+
+    sdl::quit(sdl::SDL_IMAGE);
+}
+#endif
+
+bool writeJson(const std::string& path){
+    std::ofstream out(path);
+    if(!out){
+        return false;
+    }
+
+    out << "{\n  \"benchmarks\": [\n";
+    char line[256];
+    for(size_t i = 0; i < results.size(); i++){
+        snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"ns_per_op\": %.3f, \"iterations\": %llu}%s\n",
+                 results[i].name.c_str(), results[i].ns_per_op, (unsigned long long)results[i].iterations, i + 1 < results.size() ? "," : "");
+        out << line;
+    }
+    out << "  ]\n}\n";
+
+    return out.good();
+}
+
+// Reads back what writeJson produced, one benchmark per line
+bool readJson(const std::string& path, std::map<std::string, double>& baseline){
+    std::ifstream in(path);
+    if(!in){
+        return false;
+    }
+
+    std::string line;
+    while(std::getline(in, line)){
+        size_t name = line.find("\"name\": \"");
+        size_t value = line.find("\"ns_per_op\": ");
+        if(name == std::string::npos || value == std::string::npos){
+            continue;
+        }
+        name += strlen("\"name\": \"");
+        size_t end = line.find('"', name);
+        baseline[line.substr(name, end - name)] = atof(line.c_str() + value + strlen("\"ns_per_op\": "));
+    }
+    return true;
+}
+
+int main(int argc, char* args[]){
+    std::string json, baseline_path;
+    double threshold = 10.0;
+
+    for(int i = 1; i < argc; i++){
+        if(i + 1 < argc && strcmp(args[i], "--json") == 0){
+            json = args[++i];
+        }
+        else if(i + 1 < argc && strcmp(args[i], "--baseline") == 0){
+            baseline_path = args[++i];
+        }
+        else if(i + 1 < argc && strcmp(args[i], "--threshold") == 0){
+            threshold = atof(args[++i]);
+        }
+        else if(i + 1 < argc && strcmp(args[i], "--filter") == 0){
+            filter = args[++i];
+        }
+        else if(i + 1 < argc && strcmp(args[i], "--min-time") == 0){
+            min_time = atof(args[++i]);
+        }
+        else {
+            fprintf(stderr, "usage: %s [--json <out.json>] [--baseline <in.json>] [--threshold <percent>] [--filter <substring>] [--min-time <seconds>]\n", args[0]);
+            return 1;
+        }
+    }
+
+    if(!checkBallBatch()){
+        return 1;
+    }
+
+    benchVector();
+    benchCollides();
+    benchBall();
+    benchBallBatch();
+    benchWorld();
+    benchBalls();
+    benchPreview();
+    benchCompositor();
+#ifndef NO_SDL
+    benchFrame();
+#endif
+
+    if(!json.empty() && !writeJson(json)){
+        fprintf(stderr, "Failed to write %s\n", json.c_str());
+        return 1;
+    }
+
+    if(baseline_path.empty()){
+        return 0;
+    }
+
+    std::map<std::string, double> baseline;
+    if(!readJson(baseline_path, baseline)){
+        fprintf(stderr, "Failed to read baseline %s\n", baseline_path.c_str());
+        return 1;
+    }
+
+    int regressions = 0;
+    printf("\n%-44s %12s %12s %9s\n", "compared to baseline", "ns/op", "baseline", "change");
+    for(const Result& result : results){
+        auto it = baseline.find(result.name);
+        if(it == baseline.end() || it->second <= 0.0){
+            printf("%-44s %12.2f %12s\n", result.name.c_str(), result.ns_per_op, "-");
+            continue;
+        }
+
+        double change = (result.ns_per_op / it->second - 1.0) * 100.0;
+        bool regressed = change > threshold;
+        regressions += regressed;
+        printf("%-44s %12.2f %12.2f %+8.1f%%%s\n", result.name.c_str(), result.ns_per_op, it->second, change, regressed ? "  REGRESSION" : "");
+    }
+
+    printf("%d regression%s over %.1f%%\n", regressions, regressions == 1 ? "" : "s", threshold);
+    return regressions > 0 ? 1 : 0;
+}
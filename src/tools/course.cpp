@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../sim/Course.h"
+#include "../sim/CourseFile.h"
+#include "../sim/Generator.h"
+#include "../sim/ThreadPool.h"
+
+// Converts courses between the binary format and the text form
+// usage: course totext <in.course> [out.txt]
+//        course tobin <in.txt> <out.course>
+//        course random <seed> <out.course>
+//        course batch <first_seed> <count> <out_dir> [threads]
+int main(int argc, char* args[]){
+    if(argc < 3){
+        fprintf(stderr, "usage: %s totext <in.course> [out.txt] | tobin <in.txt> <out.course> | random <seed> <out.course>"
+                        " | batch <first_seed> <count> <out_dir> [threads]\n", args[0]);
+        return 1;
+    }
+
+    if(strcmp(args[1], "totext") == 0){
+        sim::CourseFile file;
+        if(!file.open(args[2])){
+            fprintf(stderr, "Failed to open course file %s\n", args[2]);
+            return 1;
+        }
+
+        if(argc > 3){
+            std::ofstream out(args[3]);
+            sim::CourseFile::writeText(out, file.toCourse());
+        }
+        else {
+            sim::CourseFile::writeText(std::cout, file.toCourse());
+        }
+        return 0;
+    }
+
+    if(argc < 4){
+        fprintf(stderr, "%s needs an output file\n", args[1]);
+        return 1;
+    }
+
+    if(strcmp(args[1], "batch") == 0){
+        if(argc < 5){
+            fprintf(stderr, "batch needs a seed, a count and an output directory\n");
+            return 1;
+        }
+
+        uint64_t first_seed = strtoull(args[2], nullptr, 10);
+        size_t count = strtoull(args[3], nullptr, 10);
+        std::string dir = args[4];
+
+        sim::ThreadPool pool(argc > 5 ? atoi(args[5]) : 0);
+        sim::CourseGenerator generator;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<sim::Course> courses = generator.generateBatch(pool, first_seed, count);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        for(size_t i = 0; i < courses.size(); i++){
+            std::string path = dir + "/" + std::to_string(first_seed + i) + ".course";
+            if(!sim::CourseFile::write(path, courses[i])){
+                fprintf(stderr, "Failed to write course file %s\n", path.c_str());
+                return 1;
+            }
+        }
+
+        printf("generated %zu courses on %u threads in %.1f ms\n", courses.size(), pool.size(), elapsed.count());
+        return 0;
+    }
+
+    sim::Course course;
+    if(strcmp(args[1], "tobin") == 0){
+        std::ifstream in(args[2]);
+        if(!in || !sim::CourseFile::readText(in, course)){
+            fprintf(stderr, "Failed to read course text %s\n", args[2]);
+            return 1;
+        }
+    }
+    else if(strcmp(args[1], "random") == 0){
+        course = sim::CourseGenerator().generate(strtoull(args[2], nullptr, 10));
+    }
+    else {
+        fprintf(stderr, "Unknown command %s\n", args[1]);
+        return 1;
+    }
+
+    if(!sim::CourseFile::write(args[3], course)){
+        fprintf(stderr, "Failed to write course file %s\n", args[3]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <poll.h>
+
+#include "Socket.h"
+#include "../sim/Event.h"
+#include "../sim/Protocol.h"
+#include "../sim/Random.h"
+
+// Load generator for the match server: keeps matches going with random shots, one per ball at rest, and
+// reports throughput and latency. Every match plays until the ball drops or MAX_STROKES, then a new one starts
+// usage: loadgen [address] [matches] [connections] [seconds] [balls] [seed]
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int MAX_STROKES = 10;
+
+struct Game {
+    Clock::time_point sent;
+    bool answered = false;
+};
+
+struct Client {
+    net::Connection connection;
+
+    // Keyed by tag until CREATED, then by match id
+    std::unordered_map<uint32_t, Clock::time_point> creating;
+    std::unordered_map<uint32_t, Game> games;
+};
+
+struct Stats {
+    uint64_t created = 0;
+    uint64_t finished = 0;
+    uint64_t holed = 0;
+    uint64_t shots = 0;
+    uint64_t results = 0;
+    uint64_t events[sim::EventType::HOLE_IN + 1] = {};
+    uint64_t rejected = 0;
+
+    // Microseconds: CREATE to CREATED, SHOT to its swing or rejection, SHOT to the RESULT once the balls stop
+    std::vector<double> create_latency, reply_latency, result_latency;
+};
+
+double micros(Clock::time_point from, Clock::time_point to){
+    return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+void printLatency(const char* name, std::vector<double>& samples){
+    if(samples.empty()){
+        printf("%-8s no samples\n", name);
+        return;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double q){
+        return samples[std::min(samples.size() - 1, (size_t)(q * samples.size()))];
+    };
+    printf("%-8s %8zu samples, p50 %9.1f us  p90 %9.1f us  p99 %9.1f us  max %9.1f us\n",
+           name, samples.size(), at(0.5), at(0.9), at(0.99), samples.back());
+}
+
+class Generator
+{
+    public:
+        Generator(uint16_t balls, uint64_t seed) : balls(balls), random(seed) {}
+
+        void create(Client& client, uint32_t tag){
+            sim::Message message;
+            message.type = sim::MessageType::CREATE;
+            message.tag = tag;
+            message.seed = random.next();
+            message.balls = balls;
+            sim::encode(message, client.connection.out);
+            client.creating[tag] = Clock::now();
+        }
+
+        // Random direction, always hard enough that World::shoot takes it
+        void shoot(Client& client, uint32_t match){
+            float angle = random.uniform(0.0f, 2.0f * (float)M_PI);
+            float power = random.uniform(20.0f, 100.0f);
+
+            sim::Message message;
+            message.type = sim::MessageType::SHOT;
+            message.match = match;
+            message.x = cos(angle) * power;
+            message.y = sin(angle) * power;
+            sim::encode(message, client.connection.out);
+
+            Game& game = client.games[match];
+            game.sent = Clock::now();
+            game.answered = false;
+            stats.shots++;
+        }
+
+        void close(Client& client, uint32_t match){
+            sim::Message message;
+            message.type = sim::MessageType::CLOSE;
+            message.match = match;
+            sim::encode(message, client.connection.out);
+            client.games.erase(match);
+        }
+
+        // Plays the match a message is about a step further, false for a message the protocol does not allow
+        bool handle(Client& client, const sim::Message& message){
+            Clock::time_point now = Clock::now();
+
+            switch(message.type){
+                case sim::MessageType::CREATED: {
+                    auto it = client.creating.find(message.tag);
+                    if(it == client.creating.end()){
+                        return false;
+                    }
+                    stats.create_latency.push_back(micros(it->second, now));
+                    client.creating.erase(it);
+                    stats.created++;
+
+                    // The tag is free again, it stands for a slot rather than a match
+                    tags.push_back(message.tag);
+                    shoot(client, message.match);
+                    break;
+                }
+                case sim::MessageType::EVENT: {
+                    if(message.event <= sim::EventType::HOLE_IN){
+                        stats.events[message.event]++;
+                    }
+                    auto it = client.games.find(message.match);
+                    if(message.event == sim::EventType::SWING && it != client.games.end() && !it->second.answered){
+                        stats.reply_latency.push_back(micros(it->second.sent, now));
+                        it->second.answered = true;
+                    }
+                    break;
+                }
+                case sim::MessageType::RESULT: {
+                    auto it = client.games.find(message.match);
+                    if(it == client.games.end()){
+                        return false;
+                    }
+                    stats.result_latency.push_back(micros(it->second.sent, now));
+                    stats.results++;
+
+                    if(message.holed || message.strokes >= MAX_STROKES){
+                        stats.finished++;
+                        stats.holed += message.holed;
+                        close(client, message.match);
+                        create(client, nextTag());
+                    }
+                    else {
+                        shoot(client, message.match);
+                    }
+                    break;
+                }
+                case sim::MessageType::REJECTED:
+                    stats.rejected++;
+                    // A refused CREATE leaves its slot empty
+                    if(message.reason == sim::RejectReason::FULL || message.reason == sim::RejectReason::TOO_MANY_BALLS){
+                        client.creating.erase(message.tag);
+                    }
+                    else if(message.reason == sim::RejectReason::WEAK || message.reason == sim::RejectReason::MOVING ||
+                            message.reason == sim::RejectReason::INVALID_AIM){
+                        shoot(client, message.match);
+                    }
+                    break;
+                default:
+                    return false;
+            }
+            return true;
+        }
+
+        uint32_t nextTag(){
+            if(tags.empty()){
+                return next_tag++;
+            }
+            uint32_t tag = tags.back();
+            tags.pop_back();
+            return tag;
+        }
+
+        Stats stats;
+
+    private:
+        uint16_t balls;
+        sim::Random random;
+
+        std::vector<uint32_t> tags;
+        uint32_t next_tag = 0;
+};
+}
+
+int main(int argc, char* args[]){
+    std::string address = argc > 1 ? args[1] : "7777";
+    int matches = argc > 2 ? atoi(args[2]) : 1000;
+    int connections = argc > 3 ? atoi(args[3]) : 4;
+    double seconds = argc > 4 ? atof(args[4]) : 10.0;
+    uint16_t balls = argc > 5 ? (uint16_t)atoi(args[5]) : 0;
+    uint64_t seed = argc > 6 ? strtoull(args[6], nullptr, 10) : 1;
+
+    connections = std::max(1, std::min(connections, matches));
+
+    Generator generator(balls, seed);
+    std::vector<Client> clients(connections);
+    for(int i = 0; i < connections; i++){
+        Client& client = clients[i];
+        client.connection.fd = net::connectTo(address);
+        if(client.connection.fd < 0 || !net::setNonBlocking(client.connection.fd)){
+            perror(("Failed to connect to " + address).c_str());
+            return 1;
+        }
+
+        // Spread as evenly as the count allows
+        int count = matches / connections + (i < matches % connections ? 1 : 0);
+        for(int j = 0; j < count; j++){
+            generator.create(client, generator.nextTag());
+        }
+    }
+
+    printf("%d matches over %d connections to %s for %.1f s, %u balls each\n", matches, connections, address.c_str(), seconds, balls);
+    fflush(stdout);
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    Clock::time_point next_report = start + std::chrono::seconds(1);
+    uint64_t reported_shots = 0, reported_results = 0;
+
+    std::vector<pollfd> fds(connections);
+    bool failed = false;
+
+    while(!failed && Clock::now() < end){
+        for(int i = 0; i < connections; i++){
+            fds[i] = {clients[i].connection.fd, (short)(POLLIN | (clients[i].connection.out.empty() ? 0 : POLLOUT)), 0};
+        }
+
+        if(poll(fds.data(), fds.size(), 10) < 0 && errno != EINTR){
+            perror("poll");
+            break;
+        }
+
+        for(int i = 0; i < connections && !failed; i++){
+            net::Connection& connection = clients[i].connection;
+
+            if(fds[i].revents & (POLLIN | POLLHUP | POLLERR)){
+                if(!connection.receive()){
+                    fprintf(stderr, "Server closed connection %d\n", i);
+                    failed = true;
+                }
+            }
+
+            size_t offset = 0;
+            sim::Message message;
+            int size;
+            while((size = sim::decode(connection.in.data() + offset, connection.in.size() - offset, message)) != 0){
+                if(size < 0 || !generator.handle(clients[i], message)){
+                    fprintf(stderr, "Unexpected message on connection %d\n", i);
+                    failed = true;
+                    break;
+                }
+                offset += size;
+            }
+            connection.in.erase(0, offset);
+
+            if(!connection.flush()){
+                fprintf(stderr, "Failed to write to connection %d\n", i);
+                failed = true;
+            }
+        }
+
+        Clock::time_point now = Clock::now();
+        if(now >= next_report){
+            const Stats& stats = generator.stats;
+            printf("%.0f s: %llu shots/s, %llu results/s, %llu matches finished\n", std::chrono::duration<double>(now - start).count(),
+                   (unsigned long long)(stats.shots - reported_shots), (unsigned long long)(stats.results - reported_results),
+                   (unsigned long long)stats.finished);
+            fflush(stdout);
+
+            reported_shots = stats.shots;
+            reported_results = stats.results;
+            next_report += std::chrono::seconds(1);
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    for(Client& client : clients){
+        client.connection.close();
+    }
+
+    Stats& stats = generator.stats;
+    printf("\n%.2f s, %llu matches created, %llu finished, %llu holed, %llu rejected\n", elapsed,
+           (unsigned long long)stats.created, (unsigned long long)stats.finished, (unsigned long long)stats.holed,
+           (unsigned long long)stats.rejected);
+    printf("%llu shots, %.0f shots/s, %.0f results/s\n", (unsigned long long)stats.shots, stats.shots / elapsed, stats.results / elapsed);
+    printf("events: %llu swings, %llu walls, %llu tiles, %llu balls, %llu holes\n",
+           (unsigned long long)stats.events[sim::EventType::SWING], (unsigned long long)stats.events[sim::EventType::WALL_COLLISION],
+           (unsigned long long)stats.events[sim::EventType::TILE_COLLISION], (unsigned long long)stats.events[sim::EventType::BALL_COLLISION],
+           (unsigned long long)stats.events[sim::EventType::HOLE_IN]);
+    printLatency("create", stats.create_latency);
+    printLatency("reply", stats.reply_latency);
+    printLatency("result", stats.result_latency);
+
+    return failed ? 1 : 0;
+}
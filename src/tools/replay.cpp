@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../sim/Recording.h"
+
+// Plays a session recorded with `main --record` back without rendering and checks the final state
+// usage: replay <recording> [repeat]
+int main(int argc, char* args[]){
+    if(argc < 2){
+        fprintf(stderr, "usage: %s <recording> [repeat]\n", args[0]);
+        return 1;
+    }
+
+    sim::Recording recording;
+    if(!recording.load(args[1])){
+        fprintf(stderr, "Failed to read recording %s\n", args[1]);
+        return 1;
+    }
+
+    int repeat = argc > 2 ? atoi(args[2]) : 1;
+    if(repeat <= 0){
+        fprintf(stderr, "repeat must be a positive count, got %s\n", args[2]);
+        return 1;
+    }
+
+    printf("seed %llu, %zu inputs, %u ticks of %.4f s, %zu course files\n", (unsigned long long)recording.seed,
+           recording.inputs.size(), recording.final_tick, recording.dt, recording.courses.size());
+
+    bool matched = true;
+    double seconds = 0.0;
+    sim::ReplayResult result = {0, 0, 0, false, 0.0};
+    for(int i = 0; i < repeat; i++){
+        result = sim::replay(recording);
+        matched = matched && result.matched;
+        seconds += result.seconds;
+    }
+
+    printf("%d shots, %u ticks in %.3f ms per replay, %.1f M ticks/s\n", result.shots, result.ticks,
+           seconds / repeat * 1000.0, result.ticks * (double)repeat / seconds / 1000000.0);
+    printf("final hash %016llx, recorded %016llx: %s\n", (unsigned long long)result.hash,
+           (unsigned long long)recording.final_hash, matched ? "match" : "MISMATCH");
+
+    return matched ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include "Socket.h"
+#include "../sim/MatchHost.h"
+#include "../sim/Protocol.h"
+#include "../sim/Recording.h"
+#include "../sim/ThreadPool.h"
+
+// Headless match server for bots and tournaments: hosts independent games on randomized courses and steps the
+// moving ones on a pool as big as the machine. Clients speak sim/Protocol.h, results and events stream back
+// usage: server [address] [rate] [threads] [max_matches]
+//   address      unix:<path> or [host:]port, 7777 by default
+//   rate         ticks per second, 0 steps as fast as the matches go, 62.5 by default like the game
+namespace {
+
+volatile std::sig_atomic_t stopping = 0;
+
+void onSignal(int){
+    stopping = 1;
+}
+
+// A client that reads this far behind is dropped rather than buffered for without end
+const size_t MAX_BACKLOG = 64 << 20;
+
+// Ticks run back to back after a stall before the rest is dropped, as in sim::Simulation
+const int MAX_CATCH_UP = 8;
+
+struct Stats {
+    uint64_t ticks = 0;
+    uint64_t received = 0;
+    uint64_t sent = 0;
+    double step_total = 0.0;
+    double step_max = 0.0;
+};
+}
+
+int main(int argc, char* args[]){
+    std::string address = argc > 1 ? args[1] : "7777";
+    double rate = argc > 2 ? atof(args[2]) : 62.5;
+    unsigned int threads = argc > 3 ? atoi(args[3]) : 0;
+    size_t max_matches = argc > 4 ? strtoul(args[4], nullptr, 10) : 100000;
+
+    int listener = net::listenOn(address);
+    if(listener < 0 || !net::setNonBlocking(listener)){
+        perror(("Failed to listen on " + address).c_str());
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Same layout App::init builds from the textures in res/imgs
+    sim::Recording setup;
+    setup.dt = rate > 0.0 ? 1.0 / rate : 0.016;
+    setup.width = 480;
+    setup.height = 640;
+    setup.ball_scale = math::Vector2f(16, 16);
+    setup.hole_scale = math::Vector2f(16, 16);
+    setup.tile_scale = math::Vector2f(64, 64);
+    setup.tile_count = 5;
+
+    sim::ThreadPool pool(threads);
+    sim::MatchHost host(pool, setup, max_matches);
+
+    printf("listening on %s, %g ticks/s, %u threads, up to %zu matches\n", address.c_str(), rate, pool.size(), max_matches);
+    fflush(stdout);
+
+    std::unordered_map<uint32_t, net::Connection> clients;
+    uint32_t next_client = 1;
+
+    std::vector<pollfd> fds;
+    std::vector<uint32_t> polled;
+
+    std::chrono::steady_clock::duration tick_length = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(setup.dt));
+    std::chrono::steady_clock::time_point next_tick = std::chrono::steady_clock::now() + tick_length;
+    std::chrono::steady_clock::time_point next_report = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    Stats stats, reported;
+    uint64_t reported_match_ticks = 0;
+
+    while(!stopping){
+        fds.clear();
+        polled.clear();
+        fds.push_back({listener, POLLIN, 0});
+        for(const auto& entry : clients){
+            fds.push_back({entry.second.fd, (short)(POLLIN | (entry.second.out.empty() ? 0 : POLLOUT)), 0});
+            polled.push_back(entry.first);
+        }
+
+        // Sleep until the next tick is due, or not at all while unthrottled matches roll
+        int timeout = 100;
+        if(rate > 0.0){
+            std::chrono::steady_clock::duration left = next_tick - std::chrono::steady_clock::now();
+            timeout = std::max(0, (int)std::chrono::ceil<std::chrono::milliseconds>(left).count());
+        }
+        else if(host.getMovingCount() > 0){
+            timeout = 0;
+        }
+
+        if(poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR){
+            perror("poll");
+            break;
+        }
+
+        if(fds[0].revents & POLLIN){
+            int fd;
+            while((fd = accept(listener, nullptr, nullptr)) >= 0){
+                net::setNonBlocking(fd);
+                net::setNoDelay(fd);
+                clients[next_client++].fd = fd;
+            }
+        }
+
+        for(size_t i = 1; i < fds.size(); i++){
+            if(fds[i].revents == 0){
+                continue;
+            }
+
+            uint32_t id = polled[i - 1];
+            net::Connection& client = clients[id];
+
+            bool open = !(fds[i].revents & (POLLERR | POLLNVAL));
+            if(open && (fds[i].revents & (POLLIN | POLLHUP))){
+                open = client.receive();
+            }
+
+            size_t offset = 0;
+            sim::Message message;
+            int size;
+            while(open && (size = sim::decode(client.in.data() + offset, client.in.size() - offset, message)) != 0){
+                if(size < 0){
+                    open = false;
+                    break;
+                }
+                offset += size;
+                stats.received++;
+
+                switch(message.type){
+                    case sim::MessageType::CREATE:
+                        host.create(id, message.tag, message.seed, message.balls);
+                        break;
+                    case sim::MessageType::SHOT:
+                        host.shoot(id, message.match, math::Vector2f(message.x, message.y));
+                        break;
+                    case sim::MessageType::CLOSE:
+                        host.close(id, message.match);
+                        break;
+                    default:
+                        // Server messages have no business coming from a client
+                        open = false;
+                        break;
+                }
+            }
+            client.in.erase(0, offset);
+
+            if(!open){
+                host.closeAll(id);
+                client.close();
+                clients.erase(id);
+            }
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        int substeps = 0;
+        while((rate <= 0.0 ? substeps == 0 && host.getMovingCount() > 0 : next_tick <= now) && substeps < MAX_CATCH_UP){
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            host.step();
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            stats.ticks++;
+            stats.step_total += elapsed;
+            stats.step_max = std::max(stats.step_max, elapsed);
+
+            next_tick += tick_length;
+            substeps++;
+        }
+        if(rate > 0.0 && next_tick <= now){
+            next_tick = now + tick_length;
+        }
+
+        for(const sim::Delivery& delivery : host.getOutbox()){
+            auto it = clients.find(delivery.owner);
+            if(it != clients.end()){
+                sim::encode(delivery.message, it->second.out);
+                stats.sent++;
+            }
+        }
+        host.clearOutbox();
+
+        for(auto it = clients.begin(); it != clients.end();){
+            net::Connection& client = it->second;
+            if(!client.out.empty() && (!client.flush() || client.out.size() > MAX_BACKLOG)){
+                host.closeAll(it->first);
+                client.close();
+                it = clients.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        if(now >= next_report){
+            uint64_t ticks = stats.ticks - reported.ticks;
+            printf("%zu clients, %zu matches, %zu moving | %llu ticks, %.2f M match ticks/s, step %.3f ms mean %.3f ms max | %llu in, %llu out\n",
+                   clients.size(), host.size(), host.getMovingCount(), (unsigned long long)ticks,
+                   (host.getMatchTicks() - reported_match_ticks) / 1000000.0,
+                   ticks > 0 ? (stats.step_total - reported.step_total) / ticks : 0.0, stats.step_max,
+                   (unsigned long long)(stats.received - reported.received), (unsigned long long)(stats.sent - reported.sent));
+            fflush(stdout);
+
+            stats.step_max = 0.0;
+            reported = stats;
+            reported_match_ticks = host.getMatchTicks();
+            next_report = now + std::chrono::seconds(1);
+        }
+    }
+
+    for(auto& entry : clients){
+        entry.second.close();
+    }
+    close(listener);
+
+    net::Address local = net::parseAddress(address);
+    if(local.local){
+        unlink(local.path.c_str());
+    }
+
+    printf("%llu ticks, %llu match ticks, %llu messages in, %llu out\n", (unsigned long long)stats.ticks,
+           (unsigned long long)host.getMatchTicks(), (unsigned long long)stats.received, (unsigned long long)stats.sent);
+    return 0;
+}
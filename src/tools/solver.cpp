@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../sim/World.h"
+#include "../sim/Course.h"
+#include "../sim/Solver.h"
+#include "../sim/ThreadPool.h"
+
+// Headless course QA: lists every shot that sinks the ball on a randomized course
+// usage: solver [seed] [angle_steps] [power_steps] [threads] [stepped|event]
+int main(int argc, char* args[]){
+    unsigned int seed = argc > 1 ? strtoul(args[1], nullptr, 10) : 0;
+
+    sim::SolverOptions options;
+    if(argc > 2){
+        options.angle_steps = atoi(args[2]);
+    }
+    if(argc > 3){
+        options.power_steps = atoi(args[3]);
+    }
+    unsigned int threads = argc > 4 ? atoi(args[4]) : 0;
+    if(argc > 5 && strcmp(args[5], "event") == 0){
+        options.mode = sim::MotionMode::EVENT_DRIVEN;
+    }
+
+    // Same layout App::init builds from the textures in res/imgs
+    sim::World world(480, 640, seed);
+    world.setBallScale(16, 16);
+    world.setHoleScale(16, 16);
+    for(int i = 0; i < 5; i++){
+        world.addTile(64, 64);
+    }
+    world.randomize();
+
+    sim::Course course = world.getCourse();
+
+    sim::ThreadPool pool(threads);
+    sim::Solver solver(pool, options);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<sim::Shot> shots = solver.solve(course);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("seed %u: ball (%g, %g) hole (%g, %g)\n", seed,
+           course.ball_position.x, course.ball_position.y, course.hole_position.x, course.hole_position.y);
+    printf("%zu shots on %u threads in %.1f ms, %zu sink the ball\n",
+           solver.getShotCount(), pool.size(), elapsed.count(), shots.size());
+
+    for(const sim::Shot& shot : shots){
+        printf("angle %7.2f power %6.2f aim (%8.3f, %8.3f) ticks %d\n",
+               shot.angle * 180.0f / M_PI, shot.power, shot.aim.x, shot.aim.y, shot.ticks);
+    }
+
+    return 0;
+}